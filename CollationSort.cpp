@@ -0,0 +1,104 @@
+#include "CollationSort.h"
+
+namespace {
+    // Below this a single thread is faster than splitting the work
+    constexpr int ParallelThreshold = 4096;
+
+    struct Range { int begin; int end; };
+
+    std::vector<Range> chunks(int count) {
+        const int parts = count < ParallelThreshold ? 1 : std::max(QThread::idealThreadCount(), 1);
+        const int size = (count + parts - 1) / std::max(parts, 1);
+
+        std::vector<Range> ranges;
+        for (int begin = 0; begin < count; begin += size) 
+            ranges.push_back({ begin, std::min(begin + size, count) });
+        return ranges;
+    }
+
+    // Copies of a QCollator share one backend, so workers get a fresh one with the same settings
+    QCollator clone(const QCollator &collator) {
+        QCollator copy(collator.locale());
+        copy.setCaseSensitivity(collator.caseSensitivity());
+        copy.setNumericMode(collator.numericMode());
+        copy.setIgnorePunctuation(collator.ignorePunctuation());
+        return copy;
+    }
+}
+
+std::vector<QCollatorSortKey> CollationSort::keys(const QCollator &collator, int count, const std::function<QString(int)> &textAt) {
+    const std::vector<Range> ranges = chunks(count);
+
+    // QCollator is not shared across threads, every chunk gets its own instance
+    auto keysOf = [&collator, &textAt](const Range &range) {
+        QCollator local = clone(collator);
+        std::vector<QCollatorSortKey> part;
+        part.reserve(range.end - range.begin);
+
+        for (int i = range.begin; i < range.end; ++i) 
+            part.push_back(local.sortKey(textAt(i)));
+        return part;
+    };
+
+    std::vector<QCollatorSortKey> result;
+    result.reserve(count);
+
+    if (ranges.size() <= 1) {
+        for (const Range &range : ranges) 
+            for (QCollatorSortKey &key : keysOf(range)) 
+                result.push_back(std::move(key));
+        return result;
+    }
+
+    const QList<std::vector<QCollatorSortKey>> parts = QtConcurrent::blockingMapped<QList<std::vector<QCollatorSortKey>>>(ranges, keysOf);
+    for (const std::vector<QCollatorSortKey> &part : parts) 
+        result.insert(result.end(), part.begin(), part.end());
+
+    return result;
+}
+
+std::vector<int> CollationSort::order(const std::vector<QCollatorSortKey> &keys) {
+    std::vector<int> indices(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    auto less = [&keys](int a, int b) { return keys[a].compare(keys[b]) < 0; };
+
+    std::vector<Range> ranges = chunks(int(keys.size()));
+    if (ranges.size() <= 1) {
+        std::stable_sort(indices.begin(), indices.end(), less);
+        return indices;
+    }
+
+    QtConcurrent::blockingMap(ranges, [&indices, &less](const Range &range) {
+        std::stable_sort(indices.begin() + range.begin, indices.begin() + range.end, less);
+    });
+
+    // Merge neighbouring runs pairwise, each round in parallel
+    while (ranges.size() > 1) {
+        std::vector<std::pair<Range, Range>> pairs;
+        std::vector<Range> merged;
+
+        for (size_t i = 0; i + 1 < ranges.size(); i += 2) {
+            pairs.push_back({ ranges[i], ranges[i + 1] });
+            merged.push_back({ ranges[i].begin, ranges[i + 1].end });
+        }
+        if (ranges.size() % 2) 
+            merged.push_back(ranges.back());
+
+        QtConcurrent::blockingMap(pairs, [&indices, &less](const std::pair<Range, Range> &pair) {
+            std::inplace_merge(indices.begin() + pair.first.begin, indices.begin() + pair.second.begin, 
+                               indices.begin() + pair.second.end, less);
+        });
+
+        ranges.swap(merged);
+    }
+
+    return indices;
+}
+
+int CollationSort::lowerBound(const std::vector<QCollatorSortKey> &sorted, const QCollatorSortKey &key, bool after) {
+    auto it = after 
+        ? std::upper_bound(sorted.begin(), sorted.end(), key, [](const QCollatorSortKey &a, const QCollatorSortKey &b) { return a.compare(b) < 0; })
+        : std::lower_bound(sorted.begin(), sorted.end(), key, [](const QCollatorSortKey &a, const QCollatorSortKey &b) { return a.compare(b) < 0; });
+    return int(it - sorted.begin());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <QString>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Locale-aware sorting helpers shared by ComboModel and Menu.
+ * Sort keys are computed once per string, work is split into one chunk per core.
+ */
+namespace CollationSort {
+    /**
+     * @brief Sort keys for count strings. textAt must be safe to call from worker threads.
+     */
+    std::vector<QCollatorSortKey> keys(const QCollator &collator, int count, const std::function<QString(int)> &textAt);
+
+    /**
+     * @brief Stable ascending permutation of keys, chunks are sorted in parallel and then merged.
+     */
+    std::vector<int> order(const std::vector<QCollatorSortKey> &keys);
+
+    /**
+     * @brief Index of the first key not less than (or, with after, greater than) key in a sorted range.
+     */
+    int lowerBound(const std::vector<QCollatorSortKey> &sorted, const QCollatorSortKey &key, bool after = false);
+}
@@ -1,5 +1,10 @@
 #include "ComboBox.h"
 
+namespace {
+    bool sharedPopupEnabled = false;
+    QPointer<ComboBox> sharedPopupOwner;
+}
+
 ComboBox::ComboBox(QWidget *parent) : TextField(parent) {
     setFixedSize(QSize(250, 36));
     setDropDownButton();
@@ -7,63 +12,143 @@ ComboBox::ComboBox(QWidget *parent) : TextField(parent) {
     init();
 }
 
+ComboBox::~ComboBox() { 
+    // The shared popup must not keep pointing at this combo's model and delegate
+    unbindPopup(); 
+
+    // A producer blocked on a full stream must not wait forever
+    closeItemStream();
+}
+
 void ComboBox::init() {
     // Item Delegate
-    delegate = new Delegate(this->size());
+    delegate = new Delegate(this->size(), this);
+    delegate->setAsyncIcons(true);
     
     // Popup
-    popup = new Popup(this);
-    popup->setModel(&model);
-    popup->setItemDelegate(delegate);
-    popup->setSelectionMode(QAbstractItemView::SingleSelection);
-    popup->setPopupWidth(this->width());
+    itemSource = items.get();
+    filterModel.setSourceModel(itemSource);
+    _popupWidth = this->width();
+    isSharedPopup = sharedPopupEnabled;
+
+    if (!isSharedPopup) {
+        popup = new Popup(this);
+        configurePopup();
+    }
     
-    // Auto Completer
-    completer = new QCompleter(&model, this);
-    completer->setCaseSensitivity(Qt::CaseInsensitive);
-    completer->setCompletionMode(QCompleter::InlineCompletion);
-    completer->setFilterMode(Qt::MatchContains);
-    setCompleter(completer);
+    // Typed text filters the popup off the GUI thread
+    connect(this, &QLineEdit::textEdited, this, &ComboBox::onFilterTextEdited);
 
-    // Install Event Filter
-    qApp->installEventFilter(this);
+    // Rows changing under an active filter run the query again, at most once per interval
+    // so a stream of batches doesn't rebuild the filter index for every batch
+    refilterTimer = new QTimer(this);
+    refilterTimer->setSingleShot(true);
+    refilterTimer->setInterval(100);
+
+    connect(refilterTimer, &QTimer::timeout, this, &ComboBox::refilter);
+    connect(&filterModel, &ComboFilterModel::filterDropped, this, &ComboBox::scheduleRefilter);
+    connectItemSource();
 
     // Dropdown Button Signal Slot
     if (dropdown)  connect(dropdown, &Button::clicked, this, &ComboBox::onDropDownButtonClicked);
+}
 
-    // List item Signal Slot
-    connect(popup->list(), &QListView::clicked, this, &ComboBox::onComboItemClicked);
+void ComboBox::setSharedPopupEnabled(bool enable) { sharedPopupEnabled = enable; }
+bool ComboBox::isSharedPopupEnabled() { return sharedPopupEnabled; }
+
+Popup *ComboBox::sharedPopup() {
+    static QPointer<Popup> shared;
+
+    if (!shared) {
+        shared = new Popup(nullptr);
+        connect(qApp, &QCoreApplication::aboutToQuit, shared, &QObject::deleteLater);
+    }
+
+    return shared;
 }
 
-bool ComboBox::eventFilter(QObject *obj, QEvent *event) {
-    if (!popup || !isVisible()) 
-        return false;
+void ComboBox::bindPopup() {
+    if (popup) 
+        return;
 
-    if (event->type() == QEvent::MouseButtonPress) {
-        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
-        QPoint globalPos = mouseEvent->globalPosition().toPoint();
-        QWidget *clickedWidget = QApplication::widgetAt(globalPos);
+    // Whoever holds the shared popup gives it up first
+    if (sharedPopupOwner && sharedPopupOwner != this) 
+        sharedPopupOwner->unbindPopup();
 
-        bool clickedInsidePopup = popup->isAncestorOf(clickedWidget);
-        bool clickedOnTextField = this->isAncestorOf(clickedWidget);
+    sharedPopupOwner = this;
+    popup = sharedPopup();
+    configurePopup();
+}
 
-        if (popup->isVisible() && !clickedInsidePopup && !clickedOnTextField) 
-            popup->fadeOut();
-    }
+void ComboBox::unbindPopup() {
+    if (!isSharedPopup || !popup) 
+        return;
+
+    for (const QMetaObject::Connection &connection : popupConnections) 
+        disconnect(connection);
+    popupConnections.clear();
 
-    if (event->type() == QEvent::ApplicationDeactivate) 
-        if (popup->isVisible()) popup->fadeOut();
+    IdleScheduler::instance()->cancel(QString("ComboBox:%1:popup").arg(quintptr(this)));
 
-    return QObject::eventFilter(obj, event);
+    popup->hide();
+    OverlayLayer::release(popup);
+    popup->setAnchorWidget(nullptr);
+    popup->setModel(nullptr);
+    popup->setItemDelegate(nullptr);
+
+    hasPreparedPlacement = false;
+    if (sharedPopupOwner == this) 
+        sharedPopupOwner = nullptr;
+    popup = nullptr;
+}
+
+void ComboBox::configurePopup() {
+    Popup *p = popup;
+
+    p->setModel(&filterModel);
+    p->setItemDelegate(delegate);
+    p->setSelectionMode(QAbstractItemView::SingleSelection);
+    p->setAnchorWidget(this);
+    p->setMaxVisibleItems(_maxVisibleItems);
+    p->setDarkMode(isDarkMode);
+    p->setInstantOpen(isInstantOpen);
+    p->setVariableRowHeights(hasVariableRows);
+    p->setPopupWidth(_popupWidth);
+
+    if (currentItem.isValid()) 
+        p->list()->setCurrentIndex(filterModel.mapFromSource(currentItem));
+
+    // List item Signal Slot
+    popupConnections << connect(p->list(), &QListView::clicked, this, &ComboBox::onComboItemClicked);
+
+    // Click to interactive latency
+    popupConnections << connect(p, &Popup::opened, this, [this]() {
+        if (!openTimer.isValid()) 
+            return;
+
+        _lastOpenLatency = openTimer.nsecsElapsed();
+        openTimer.invalidate();
+        emit popupOpened(_lastOpenLatency);
+    });
+}
+
+bool ComboBox::isPopupOpen() const { return popup && popup->isVisible(); }
+
+int ComboBox::highlightedRow() const {
+    return popup ? filterModel.mapToSource(popup->list()->currentIndex()).row() : -1;
 }
 
 void ComboBox::setFieldSize(const QSize &fieldSize) {
     TextField::setFixedSize(fieldSize); 
-    popup->setPopupWidth(this->width());
+    setPopupWidth(this->width());
     update(); 
 }
 
-void ComboBox::setPopupWidth(int width) { popup->setPopupWidth(width); }
+void ComboBox::setPopupWidth(int width) { 
+    _popupWidth = width;
+    if (popup) 
+        popup->setPopupWidth(width); 
+}
 
 void ComboBox::setIconic(bool value) {
     isIconic = value;
@@ -82,7 +167,8 @@ void ComboBox::setDarkMode(bool value) {
     TextField::setDarkMode(value);
 
     dropdown->setDarkMode(value);
-    popup->setDarkMode(value);
+    if (popup) 
+        popup->setDarkMode(value);
     delegate->setDarkMode(value);
 
     updateItemIcons();
@@ -110,40 +196,129 @@ void ComboBox::positionDropDownButton() {
 }
 
 void ComboBox::addItem(const QString &text, const QString &lightIcon, const QString &darkIcon) {
-    items.append({text, lightIcon, darkIcon});
-    
-    QStandardItem *item;
-    if (!lightIcon.isEmpty() && !darkIcon.isEmpty()) 
-        item = new QStandardItem(QIcon(isDarkMode ? darkIcon : lightIcon), text);
-    else 
-        item = new QStandardItem(text);
-    
-    model.appendRow(item);
-    popup->updatePopup();
+    items->append(text, lightIcon, darkIcon);
+    if (popup) 
+        popup->updatePopup();
+}
+
+void ComboBox::addItems(const QVector<ComboItem> &comboItems) {
+    items->append(comboItems);
+    if (popup) 
+        popup->updatePopup();
+}
+
+void ComboBox::addItems(const QStringList &texts) {
+    items->append(texts);
+    if (popup) 
+        popup->updatePopup();
+}
+
+void ComboBox::setItems(const QVector<ComboItem> &comboItems) {
+    items->setItems(comboItems);
+    if (popup) 
+        popup->updatePopup();
+}
+
+void ComboBox::setItems(const QStringList &texts) {
+    items->setItems(texts);
+    if (popup) 
+        popup->updatePopup();
+}
+
+std::shared_ptr<ItemStream<ComboBox::ComboItem>> ComboBox::streamItems(int capacity) {
+    closeItemStream();
+
+    auto stream = std::make_shared<ItemStream<ComboItem>>(capacity);
+    itemStream = stream;
+
+    streamDrainer = new StreamDrainer([this, stream](int maxItems) {
+        std::vector<ComboItem> batch;
+        const int taken = stream->drain(batch, maxItems);
+
+        if (taken == 0) 
+            return stream->isFinished() ? -1 : 0;
+
+        items->append(std::move(batch));
+        if (popup) 
+            popup->updatePopup();
+        return taken;
+    }, this);
+
+    connect(streamDrainer, &StreamDrainer::finished, this, [this]() {
+        closeItemStream();
+        emit itemsStreamFinished();
+    });
+
+    streamDrainer->start();
+    return stream;
 }
 
-void ComboBox::addItems(const QVector<ComboItem> comboItems) {
-    for (const ComboItem &ci : comboItems) 
-        addItem(ci.text, ci.lightIcon, ci.darkIcon);
+void ComboBox::closeItemStream() {
+    if (itemStream) 
+        itemStream->close();
+    itemStream.reset();
+
+    if (streamDrainer) {
+        streamDrainer->stop();
+        streamDrainer->deleteLater();
+    }
+    streamDrainer = nullptr;
 }
 
 void ComboBox::onComboItemClicked(const QModelIndex &index) {
-    setText(currentText());
+    const int row = filterModel.mapToSource(index).row();
+    if (row < 0) 
+        return;
 
-    if (isIconic && index.row() < items.size()) {
-        const ComboItem &ci = items[index.row()];
-        setIconPaths(ci.lightIcon, ci.darkIcon);
+    if (isMultiSelectMode) {
+        selection.toggle(row);
+        currentItem = itemSource->index(row, 0);
+        onSelectionChanged();
+        return;
     }
 
+    currentItem = itemSource->index(row, 0);
+    setText(itemText(row));
+
+    if (isIconic) 
+        setIconPaths(itemIcon(row, false), itemIcon(row, true));
+
     repaint();
     popup->fadeOut();
 }
 
 void ComboBox::onDropDownButtonClicked() {
-    popup->isVisible() ? popup->fadeOut() : positionPopup(); 
+    isPopupOpen() ? popup->fadeOut() : openPopup(); 
+}
+
+void ComboBox::openPopup() {
+    openTimer.start();
+    bindPopup();
+
+    // Opening by hand always lists every item
+    clearFilter();
+    positionPopup();
 }
 
 void ComboBox::positionPopup() {
+    if (!isInstantOpen || !isPopupPrepared()) 
+        preparePopup();
+
+    popup->raise();
+    popup->fadeIn();
+}
+
+bool ComboBox::isPopupPrepared() const {
+    return popup
+        && hasPreparedPlacement 
+        && preparedAnchorPos == mapToGlobal(QPoint(0, 0)) 
+        && preparedPopupSize == popup->size()
+        && OverlayLayer::isHosted(popup);
+}
+
+void ComboBox::preparePopup() {
+    popup->updatePopup();
+
     QPoint globalPos = this->mapToGlobal(QPoint(0, 0));
     QScreen *screenAtCursor = QApplication::screenAt(globalPos);
     if (!screenAtCursor) 
@@ -170,73 +345,547 @@ void ComboBox::positionPopup() {
     int x = std::clamp(currPosition.x(), screenGeometry.left(), screenGeometry.right() - popupSize.width());
     int y = std::clamp(currPosition.y(), screenGeometry.top(), screenGeometry.bottom() - popupSize.height());
 
-    popup->move(QPoint(x, y));
-    popup->raise();
-    popup->fadeIn();
+    popup->placeAt(QPoint(x, y));
+
+    hasPreparedPlacement = true;
+    preparedAnchorPos = globalPos;
+    preparedPopupSize = popupSize;
+}
+
+void ComboBox::setMaxVisibleItems(int items) { 
+    _maxVisibleItems = items; 
+    if (popup) 
+        popup->setMaxVisibleItems(items);
 }
 
-void ComboBox::setMaxVisibleItems(int items) { _maxVisibleItems = items; }
 int ComboBox::maxVisibleItems() const { return _maxVisibleItems; }
 
-void ComboBox::updateItemIcons() {
-    for (int i = 0; i < items.size(); ++i) {
-        const ComboItem &ci = items[i];
+void ComboBox::setInstantOpen(bool value) {
+    isInstantOpen = value;
+    if (popup) 
+        popup->setInstantOpen(value);
+}
 
-        if (ci.lightIcon.isEmpty() || ci.darkIcon.isEmpty())
-            continue;
+void ComboBox::setVariableRowHeights(bool value) {
+    hasVariableRows = value;
+    if (popup) 
+        popup->setVariableRowHeights(value);
+}
 
-        QStandardItem *item = model.item(i);
-        if (!item)
-            continue;
+qint64 ComboBox::lastOpenLatency() const { return _lastOpenLatency; }
 
-        item->setIcon(QIcon(isDarkMode ? ci.darkIcon : ci.lightIcon));
+void ComboBox::updateItemIcons() {
+    // The delegate picks the light or dark icon by its own theme, the model may be shared
+    // with combos in the other theme and is left alone. Rows off screen pick up the theme when painted
+    if (isPopupOpen()) {
+        popup->list()->viewport()->update();
+        popup->prefetchVisibleRows();
     }
-
-    popup->list()->viewport()->update();
 }
 
 void ComboBox::deleteItem(int index) {
-    if (index < 0 || index >= items.size()) 
+    if (index < 0 || index >= items->count()) 
         return;
-    items.removeAt(index);
-    model.removeRow(index);
+    items->remove(index);
 
-    popup->updatePopup();
+    if (itemSource != items.get()) 
+        return;
+
+    if (popup) 
+        popup->updatePopup();
 }
 
 QString ComboBox::currentText() const {
-    QModelIndex index = popup->list()->currentIndex();
-    if (index.isValid() && index.row() < items.size())
-        return index.data(Qt::DisplayRole).toString();
-
-    return QString();
+    const int row = currentIndex();
+    return row >= 0 ? itemText(row) : QString();
 }
 
-int ComboBox::currentIndex() const { return popup->list()->currentIndex().row(); }
+int ComboBox::currentIndex() const { return currentItem.isValid() ? currentItem.row() : -1; }
+
+int ComboBox::findText(const QString &text) const { return textIndex().find(text); }
+
+const ItemIndex &ComboBox::textIndex() const {
+    if (auto *combo = qobject_cast<ComboModel*>(itemSource)) 
+        return *combo->itemIndex();
+    return ownIndex;
+}
 
 void ComboBox::setCurrentItem(int index) {
-    if (index < 0 || index >= items.size()) return;
+    if (index < 0 || index >= itemCount()) return;
 
-    QModelIndex idx = popup->list()->model()->index(index, 0);
-    popup->list()->setCurrentIndex(idx);
-    setText(items[index].text);
+    if (popup) 
+        popup->list()->setCurrentIndex(filterModel.mapFromSource(itemSource->index(index, 0)));
+    currentItem = itemSource->index(index, 0);
+    setText(itemText(index));
 
     if (isIconic)
-        setIconPaths(items[index].lightIcon, items[index].darkIcon);
+        setIconPaths(itemIcon(index, false), itemIcon(index, true));
 
     update();
 }
 
 void ComboBox::clearAll() {
-    items.clear();
-    model.clear();
-    if (popup->list()) 
+    items->clear();
+    if (itemSource != items.get()) 
+        return;
+
+    if (popup) 
         popup->list()->reset();
 }
 
+void ComboBox::setSortMode(ComboModel::SortMode mode) {
+    items->setSortMode(mode);
+    if (popup) 
+        popup->updatePopup();
+}
+
+ComboModel::SortMode ComboBox::sortMode() const { return items->sortMode(); }
+
+void ComboBox::setCollator(const QCollator &collator) { items->setCollator(collator); }
+
+void ComboBox::setSourceModel(QAbstractItemModel *source) {
+    // Rebinding the same source would stack another destroyed() connection. nullptr always goes
+    // through, the pointer is already cleared when the source's destroyed() lands here
+    if (source && source == externalModel) 
+        return;
+
+    externalModel = source;
+    bindItemSource(source ? source : items.get());
+
+    // Fall back to the built-in items if the external model goes away first
+    if (source) 
+        connect(source, &QObject::destroyed, this, [this]() { setSourceModel(nullptr); });
+}
+
+QAbstractItemModel *ComboBox::sourceModel() const { return externalModel; }
+
+void ComboBox::setItemModel(std::shared_ptr<ComboModel> model) {
+    if (!model) 
+        model = std::make_shared<ComboModel>();
+    if (model == items) 
+        return;
+
+    // The old model may be owned by this combo alone, it has to outlive the disconnect in bindItemSource()
+    const bool showsItems = itemSource == items.get();
+    const std::shared_ptr<ComboModel> previous = std::exchange(items, std::move(model));
+
+    if (showsItems) 
+        bindItemSource(items.get());
+}
+
+std::shared_ptr<ComboModel> ComboBox::itemModel() const { return items; }
+
+void ComboBox::shareItemsWith(ComboBox *other) {
+    if (other && other != this) 
+        setItemModel(other->items);
+}
+
+void ComboBox::detachItems() {
+    if (items.use_count() > 1) 
+        setItemModel(items->clone());
+}
+
+void ComboBox::bindItemSource(QAbstractItemModel *next) {
+    if (next == itemSource) 
+        return;
+
+    cancelFilter();
+    disconnect(itemSource, nullptr, this, nullptr);
+
+    itemSource = next;
+    currentItem = QPersistentModelIndex();
+
+    // Only multi-select combos hold a bit per row
+    const bool hadSelection = selection.any();
+    selection.resize(0);
+    selection.resize(isMultiSelectMode ? itemSource->rowCount() : 0);
+
+    filterModel.setSourceModel(itemSource);
+    ownIndex.setModel(qobject_cast<ComboModel*>(itemSource) ? nullptr : itemSource);
+    invalidateFilterIndex();
+    connectItemSource();
+
+    if (popup) 
+        popup->updatePopup();
+    if (hadSelection) 
+        onSelectionChanged();
+}
+
+void ComboBox::connectItemSource() {
+    // Combos sharing a model all see its row changes, not just the one that made them,
+    // so each keeps its own popup height and scroll range current
+    const auto markPopupDirty = [this]() {
+        hasPreparedPlacement = false;
+        if (isPopupOpen()) 
+            popup->updatePopup();
+    };
+    connect(itemSource, &QAbstractItemModel::rowsInserted, this, markPopupDirty);
+    connect(itemSource, &QAbstractItemModel::rowsRemoved, this, markPopupDirty);
+    connect(itemSource, &QAbstractItemModel::modelReset, this, markPopupDirty);
+
+    connect(itemSource, &QAbstractItemModel::rowsInserted, this, &ComboBox::invalidateFilterIndex);
+    connect(itemSource, &QAbstractItemModel::rowsRemoved, this, &ComboBox::invalidateFilterIndex);
+    connect(itemSource, &QAbstractItemModel::modelReset, this, &ComboBox::invalidateFilterIndex);
+    connect(itemSource, &QAbstractItemModel::layoutChanged, this, &ComboBox::invalidateFilterIndex);
+    connect(itemSource, &QAbstractItemModel::rowsMoved, this, &ComboBox::invalidateFilterIndex);
+
+    // Selection bits stay aligned with the source rows
+    connect(itemSource, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) {
+        if (isMultiSelectMode) 
+            selection.insert(first, last - first + 1);
+    });
+    connect(itemSource, &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex &, int first, int last) {
+        if (!isMultiSelectMode) 
+            return;
+
+        const bool hadSelection = selection.any();
+        selection.remove(first, last - first + 1);
+        if (hadSelection) 
+            onSelectionChanged();
+    });
+    connect(itemSource, &QAbstractItemModel::rowsMoved, this, [this](const QModelIndex &, int first, int last, const QModelIndex &, int destination) {
+        if (isMultiSelectMode) 
+            selection.move(first, last - first + 1, destination);
+    });
+    connect(itemSource, &QAbstractItemModel::modelReset, this, [this]() {
+        const bool hadSelection = selection.any();
+        selection.resize(0);
+        selection.resize(isMultiSelectMode ? itemSource->rowCount() : 0);
+        if (hadSelection) 
+            onSelectionChanged();
+    });
+    connect(itemSource, &QAbstractItemModel::layoutAboutToBeChanged, this, [this]() {
+        layoutSelection.clear();
+        for (int row : selection.rows()) 
+            layoutSelection.append(QPersistentModelIndex(itemSource->index(row, 0)));
+    });
+    connect(itemSource, &QAbstractItemModel::layoutChanged, this, [this]() {
+        selection.clear();
+        for (const QPersistentModelIndex &index : std::as_const(layoutSelection)) 
+            selection.set(index.row());
+        layoutSelection.clear();
+    });
+}
+
+// Multi-select
+void ComboBox::setMultiSelect(bool value) {
+    if (isMultiSelectMode == value) 
+        return;
+
+    isMultiSelectMode = value;
+    selection.resize(0);
+    selection.resize(isMultiSelectMode ? itemCount() : 0);
+
+    delegate->setSelection(isMultiSelectMode ? &selection : nullptr);
+
+    // Multi-select shows checks, whatever indicator was set before comes back afterwards
+    if (isMultiSelectMode) {
+        hadDotIndicator = delegate->hasSelectionDotIndicator();
+        hadCheckIndicator = delegate->hasSelectionCheckIndicator();
+        delegate->setSelectionCheckIndicator(true);
+    } else if (hadDotIndicator) {
+        delegate->setSelectionDotIndicator(true);
+    } else {
+        delegate->setSelectionCheckIndicator(hadCheckIndicator);
+    }
+
+    if (popup) 
+        popup->updatePopup();
+
+    onSelectionChanged();
+}
+
+bool ComboBox::isMultiSelect() const { return isMultiSelectMode; }
+
+bool ComboBox::isSelected(int index) const { return selection.test(index); }
+
+void ComboBox::setSelected(int index, bool selected) {
+    if (index < 0 || index >= selection.size() || selection.test(index) == selected) 
+        return;
+
+    selection.set(index, selected);
+    onSelectionChanged();
+}
+
+void ComboBox::selectAll() {
+    selection.selectAll();
+    onSelectionChanged();
+}
+
+void ComboBox::clearSelection() {
+    selection.clear();
+    onSelectionChanged();
+}
+
+void ComboBox::invertSelection() {
+    selection.invert();
+    onSelectionChanged();
+}
+
+void ComboBox::selectFiltered() {
+    if (!filterModel.isFiltering()) {
+        selectAll();
+        return;
+    }
+
+    selection.setRows(filterModel.filteredRows());
+    onSelectionChanged();
+}
+
+std::vector<int> ComboBox::selectedIndexes() const { return selection.rows(); }
+int ComboBox::selectedCount() const { return selection.count(); }
+
+void ComboBox::onSelectionChanged() {
+    if (!isMultiSelectMode) 
+        return;
+
+    // The field shows the selection unless it holds typed filter text
+    if (!isEditable) {
+        const int count = selection.count();
+        setText(count == 1 ? itemText(selection.rows().front()) : count > 1 ? tr("%1 selected").arg(count) : QString());
+    }
+
+    if (isPopupOpen()) 
+        popup->list()->viewport()->update();
+
+    update();
+    emit selectionChanged();
+}
+
+int ComboBox::itemCount() const { return itemSource->rowCount(); }
+
+QString ComboBox::itemText(int row) const {
+    if (itemSource == items.get()) 
+        return items->text(row);
+    return itemSource->index(row, 0).data(Qt::DisplayRole).toString();
+}
+
+QString ComboBox::itemIcon(int row, bool dark) const {
+    if (itemSource == items.get()) 
+        return dark ? items->darkIcon(row) : items->lightIcon(row);
+    return itemSource->index(row, 0).data(dark ? ComboModel::DarkIconRole : ComboModel::LightIconRole).toString();
+}
+
+std::function<ComboModel::Snapshot()> ComboBox::snapshotTask() const {
+    // Mapped files are decoded on the worker, straight from the mapping
+    if (auto *mapped = qobject_cast<MappedItemModel*>(itemSource)) 
+        return mapped->snapshotTask();
+
+    ComboModel::Snapshot snapshot;
+
+    if (auto *combo = qobject_cast<ComboModel*>(itemSource)) {
+        snapshot = combo->snapshot();
+    } else {
+        // Arbitrary models are only safe to read on the GUI thread
+        const int rows = itemSource->rowCount();
+        snapshot.spans.reserve(rows);
+
+        for (int row = 0; row < rows; ++row) {
+            const QString text = itemSource->index(row, 0).data(Qt::DisplayRole).toString();
+            snapshot.spans.push_back({ quint32(snapshot.arena.size()), quint32(text.size()) });
+            snapshot.arena.append(text);
+        }
+    }
+
+    return [snapshot = std::move(snapshot)]() { return snapshot; };
+}
+
+bool ComboBox::isFilterRunning() const { return filterWatcher && filterWatcher->isRunning(); }
+
+void ComboBox::cancelFilter() {
+    if (!filterWatcher) 
+        return;
+
+    // Results of a superseded query must never reach the popup
+    disconnect(filterWatcher, nullptr, this, nullptr);
+    filterWatcher->cancel();
+    filterWatcher->deleteLater();
+    filterWatcher = nullptr;
+}
+
+void ComboBox::clearFilter() {
+    cancelFilter();
+
+    if (!filterModel.isFiltering()) 
+        return;
+
+    filterModel.clearFilter();
+    if (popup && currentItem.isValid()) 
+        popup->list()->setCurrentIndex(filterModel.mapFromSource(currentItem));
+}
+
+void ComboBox::invalidateFilterIndex() {
+    // A query cut short here has to run again on the new rows
+    if (filterWatcher) 
+        scheduleRefilter();
+
+    // Row numbers in the index and in previous matches are stale now
+    cancelFilter();
+    filterIndex = QFuture<std::shared_ptr<const FilterIndex>>();
+    lastFilterMatches.reset();
+    lastFilterQuery.clear();
+}
+
+void ComboBox::scheduleRefilter() {
+    if (isEditable && !refilterTimer->isActive()) 
+        refilterTimer->start();
+}
+
+void ComboBox::refilter() {
+    if (isEditable) 
+        onFilterTextEdited(text());
+}
+
+void ComboBox::onFilterTextEdited(const QString &text) {
+    if (!isEditable) 
+        return;
+
+    cancelFilter();
+
+    const QString query = FilterIndex::fold(text);
+    if (query.isEmpty()) {
+        clearFilter();
+        lastFilterMatches.reset();
+        lastFilterQuery.clear();
+        if (popup) 
+            popup->updatePopup();
+        return;
+    }
+
+    // Index is built once per model state, on the first query that needs it
+    if (!filterIndex.isValid()) {
+        // Combos listing the same ComboModel share one index
+        if (auto *combo = qobject_cast<ComboModel*>(itemSource)) {
+            filterIndex = combo->filterIndex();
+        } else {
+            filterIndex = QtConcurrent::run(QThreadPool::globalInstance(), [task = snapshotTask()]() {
+                return FilterIndex::build(task());
+            });
+        }
+    }
+
+    // Extending the previous query only needs to recheck its matches
+    std::shared_ptr<const std::vector<int>> candidates;
+    if (lastFilterMatches && !lastFilterQuery.isEmpty() && query.contains(lastFilterQuery)) 
+        candidates = lastFilterMatches;
+
+    pendingFilterQuery = query;
+    hasFilterResults = false;
+
+    filterWatcher = new QFutureWatcher<std::vector<int>>(this);
+    connect(filterWatcher, &QFutureWatcher<std::vector<int>>::resultsReadyAt, this, &ComboBox::appendFilterResults);
+    connect(filterWatcher, &QFutureWatcher<std::vector<int>>::finished, this, &ComboBox::finishFilter);
+
+    QFuture<std::shared_ptr<const FilterIndex>> index = filterIndex;
+    filterWatcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), 
+        [index, candidates, query](QPromise<std::vector<int>> &promise) {
+            // Waiting runs the build inline if it has not started yet
+            const std::shared_ptr<const FilterIndex> filter = index.result();
+            if (!filter || promise.isCanceled()) 
+                return;
+
+            filter->match(query, candidates.get(), promise);
+        }));
+}
+
+void ComboBox::appendFilterResults(int begin, int end) {
+    // The previous result set stays on screen until the first new batch arrives
+    if (!hasFilterResults) {
+        filterModel.beginResults();
+        hasFilterResults = true;
+    }
+
+    for (int i = begin; i < end; ++i) 
+        filterModel.appendResults(filterWatcher->resultAt(i));
+
+    showFilterResults();
+}
+
+void ComboBox::finishFilter() {
+    if (!hasFilterResults) 
+        filterModel.beginResults();
+
+    lastFilterQuery = pendingFilterQuery;
+    lastFilterMatches = std::make_shared<const std::vector<int>>(filterModel.filteredRows());
+
+    filterWatcher->deleteLater();
+    filterWatcher = nullptr;
+
+    showFilterResults();
+}
+
+void ComboBox::showFilterResults() {
+    if (filterModel.rowCount() == 0) {
+        if (isPopupOpen()) 
+            popup->fadeOut();
+        return;
+    }
+
+    if (isPopupOpen()) {
+        preparePopup();
+    } else if (hasFocus()) {
+        bindPopup();
+        positionPopup();
+    }
+
+    // Enter picks the best match right away
+    if (popup && !popup->list()->currentIndex().isValid()) 
+        popup->list()->setCurrentIndex(filterModel.index(0, 0));
+}
+
+void ComboBox::enterEvent(QEnterEvent *event) {
+    TextField::enterEvent(event);
+
+    // Hovering usually means the popup opens soon
+    schedulePrewarm();
+}
+
+void ComboBox::schedulePrewarm() {
+    if (isPopupOpen()) 
+        return;
+
+    const QString key = QString("ComboBox:%1").arg(quintptr(this));
+
+    IdleScheduler::instance()->schedule(key + ":popup", [this]() {
+        // A shared popup is only prepared once it is bound on open
+        if (!popup) {
+            PopupWindowPool::prewarm(PopupWindow::PopupKind);
+            return false;
+        }
+
+        popup->ensurePolished();
+        popup->updatePopup();
+        popup->list()->sizeHintForRow(0);
+
+        // Instant open also settles placement ahead of the press
+        if (isInstantOpen && !popup->isVisible()) 
+            preparePopup();
+        else 
+            PopupWindowPool::prewarm(PopupWindow::PopupKind);
+
+        return false;
+    }, IdleScheduler::High, this);
+
+    IdleScheduler::instance()->schedule(key + ":icons", [this]() {
+        delegate->prewarm(itemSource, 0, _maxVisibleItems);
+        return false;
+    }, IdleScheduler::Normal, this);
+}
+
+void ComboBox::leaveEvent(QEvent *event) {
+    TextField::leaveEvent(event);
+
+    // A prepared but unopened popup gives its native window back
+    if (popup && !popup->isVisible()) {
+        IdleScheduler::instance()->cancel(QString("ComboBox:%1:popup").arg(quintptr(this)));
+        OverlayLayer::release(popup);
+        hasPreparedPlacement = false;
+    }
+}
+
 void ComboBox::mousePressEvent(QMouseEvent *event) {
     if (!isEditable)
-        popup->isVisible() ? popup->fadeOut() : (QTimer::singleShot(300, this, [this]() { positionPopup(); }));
+        isPopupOpen() ? popup->fadeOut() : openPopup();
     else 
         QLineEdit::mousePressEvent(event);
 }
@@ -247,20 +896,39 @@ void ComboBox::mouseMoveEvent(QMouseEvent *event) {
 
 void ComboBox::keyPressEvent(QKeyEvent *event) {
     if (!isEditable) {
+        // Type-ahead jumps to the next item starting with the typed text
+        const bool open = isPopupOpen();
+        const int row = typeAhead.next(textIndex(), event->text(), open ? highlightedRow() : currentIndex());
+
+        if (row != -1 && open) {
+            const QModelIndex index = filterModel.mapFromSource(itemSource->index(row, 0));
+            popup->list()->setCurrentIndex(index);
+            popup->list()->scrollTo(index);
+        } else if (row != -1 && !isMultiSelectMode) {
+            setCurrentItem(row);
+        } else if (open && (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter) && highlightedRow() != -1) {
+            // Same as clicking the highlighted item
+            onComboItemClicked(popup->list()->currentIndex());
+        }
+
         event->accept();
     } else {
         switch (event->key()) {
             case Qt::Key_Up:
             case Qt::Key_Down: {
-                QApplication::sendEvent(popup->list(), event);
+                if (popup) 
+                    QApplication::sendEvent(popup->list(), event);
                 break;
             }
         
             case Qt::Key_Return:
             case Qt::Key_Enter: {
-                int index = currentIndex();
-                if (index != -1) {
-                    setCurrentItem(currentIndex());
+                int index = highlightedRow();
+                if (index != -1 && isMultiSelectMode) {
+                    selection.toggle(index);
+                    onSelectionChanged();
+                } else if (index != -1) {
+                    setCurrentItem(index);
                     popup->fadeOut();
                 }
                
@@ -269,7 +937,7 @@ void ComboBox::keyPressEvent(QKeyEvent *event) {
             }
         
             case Qt::Key_Escape: {
-                if (popup->isVisible())
+                if (isPopupOpen())
                     popup->fadeOut();
                 event->accept();
                 break;
@@ -8,6 +8,15 @@
 #include "ScrollBar.h"
 #include "Delegate.h"
 #include "Popup.h"
+#include "ComboModel.h"
+#include "ComboFilterModel.h"
+#include "FilterIndex.h"
+#include "MappedItemModel.h"
+#include "SelectionBitset.h"
+#include "ItemIndex.h"
+#include "ItemStream.h"
+#include "StreamDrainer.h"
+#include "IdleScheduler.h"
 #include "../../resources/IconManager.h"
 
 #include <QObject>
@@ -18,21 +27,35 @@
 #include <QKeyEvent>
 #include <QListView>
 #include <QAbstractItemView>
-#include <QStandardItemModel>
-#include <QStandardItem>
-#include <QCompleter>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QVBoxLayout>
 #include <QFrame>
 #include <QStringList>
 #include <QVector>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <utility>
 
 class ComboBox : public TextField {
     Q_OBJECT
 
     public:
     explicit ComboBox(QWidget *parent = nullptr);
+    ~ComboBox() override;
 
-    struct ComboItem { QString text; QString lightIcon = ""; QString darkIcon = ""; };
+    /**
+     * @brief Combos created afterwards own no popup of their own. They borrow one shared
+     * popup while open and rebind its model, delegate, width and theme. Off by default.
+     */
+    static void setSharedPopupEnabled(bool enable);
+    static bool isSharedPopupEnabled();
+
+    using ComboItem = ComboModel::Item;
 
     void setIconic(bool value);
     void setEditable(bool value);
@@ -42,43 +65,184 @@ class ComboBox : public TextField {
     void setPopupWidth(int width);
 
     void addItem(const QString &text, const QString &lightIcon = "", const QString &darkIcon = "");
-    void addItems(const QVector<ComboItem> comboItems);
+    void addItems(const QVector<ComboItem> &comboItems);
+    void addItems(const QStringList &texts);
+
+    /**
+     * @brief Inserts any range of ComboItem or QString elements as a single model operation,
+     * followed by one popup relayout.
+     */
+    template <typename Range, typename = std::enable_if_t<!std::is_convertible_v<Range, QString>>>
+    void addItems(Range &&range) {
+        items->append(std::forward<Range>(range));
+        if (popup) 
+            popup->updatePopup();
+    }
+
+    /**
+     * @brief Opens a stream that one worker thread pushes items into. The GUI thread drains it into
+     * the model in frame-budgeted batches; push() blocks while the stream is full. Call finish() on it
+     * when done, itemsStreamFinished() follows once the last item is in. A new stream closes the previous one.
+     */
+    std::shared_ptr<ItemStream<ComboItem>> streamItems(int capacity = 65536);
 
     void deleteItem(int index);
     void clearAll();
 
+    /**
+     * @brief Replaces the items in place: only rows that differ are inserted, removed or moved,
+     * so the current item, selection, hover and scroll position are kept.
+     */
+    void setItems(const QVector<ComboItem> &comboItems);
+    void setItems(const QStringList &texts);
+
+    /**
+     * @brief Keeps the built-in items in collation order (optionally without duplicates).
+     * The current item stays selected when rows move.
+     */
+    void setSortMode(ComboModel::SortMode mode);
+    ComboModel::SortMode sortMode() const;
+    void setCollator(const QCollator &collator);
+
+    /**
+     * @brief Lists the rows of an external model (e.g. MappedItemModel) instead of the built-in items.
+     * addItem(), deleteItem() and clearAll() keep working on the built-in items,
+     * which come back with setSourceModel(nullptr).
+     */
+    void setSourceModel(QAbstractItemModel *source);
+    QAbstractItemModel *sourceModel() const;
+
+    /**
+     * @brief The built-in items are explicitly shared: combos pointing at the same ComboModel list
+     * the same rows, and adding, removing or replacing items through any of them updates all.
+     * Current item, filter text and selection stay per combo. nullptr gives this combo a fresh, empty list.
+     */
+    void setItemModel(std::shared_ptr<ComboModel> model);
+    std::shared_ptr<ComboModel> itemModel() const;
+    void shareItemsWith(ComboBox *other);
+
+    /**
+     * @brief Gives this combo its own copy of shared items. The copy shares the text storage until either side changes.
+     */
+    void detachItems();
+
     QString currentText() const;
     int currentIndex() const;
 
+    /**
+     * @brief Index of the first item with exactly this text, or -1. Uses a hash built on first call.
+     */
+    int findText(const QString &text) const;
+
+    /**
+     * @brief Clicks toggle items and keep the popup open. Membership is a bitset over
+     * source rows, so the bulk operations below stay cheap for thousands of items.
+     */
+    void setMultiSelect(bool value);
+    bool isMultiSelect() const;
+
+    bool isSelected(int index) const;
+    void setSelected(int index, bool selected);
+    void selectAll();
+    void clearSelection();
+    void invertSelection();
+
+    /**
+     * @brief Selects every item matched by the typed filter text, or all items without one.
+     */
+    void selectFiltered();
+
+    std::vector<int> selectedIndexes() const;
+    int selectedCount() const;
+
     void setMaxVisibleItems(int items);
     int maxVisibleItems() const;
 
+    /**
+     * @brief Popup is prepared in advance (while hovering) and shown on press without fade-in.
+     */
+    void setInstantOpen(bool value);
+
+    /**
+     * @brief Lets rows differ in height, for source models serving headers, separators
+     * (Qt::UserRole + 7) or subtitles (Qt::UserRole + 8). Row offsets stay O(log n).
+     */
+    void setVariableRowHeights(bool value);
+
+    /**
+     * @brief Time from the last press to the popup being interactive, in nanoseconds.
+     */
+    qint64 lastOpenLatency() const;
+
+    /**
+     * @brief True while a background filter query for the typed text is running.
+     */
+    bool isFilterRunning() const;
+
+    signals:
+    void popupOpened(qint64 latencyNs);
+    void selectionChanged();
+    void itemsStreamFinished();
+
     private slots:
     void onDropDownButtonClicked();
     void onComboItemClicked(const QModelIndex &index);
+    void onFilterTextEdited(const QString &text);
 
     protected:
+    void enterEvent(QEnterEvent *event) override;
+    void leaveEvent(QEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
-    bool eventFilter(QObject *obj, QEvent *event);
 
     private:
-    QVector<ComboItem> items;
-
     void init();
     void positionDropDownButton();
     void positionPopup();
+    void preparePopup();
+    bool isPopupPrepared() const;
+    void openPopup();
     void updateItemIcons();
     void setDropDownButton();
+    void schedulePrewarm();
+    void bindPopup();
+    void unbindPopup();
+    void configurePopup();
+    bool isPopupOpen() const;
+    int itemCount() const;
+    QString itemText(int row) const;
+    QString itemIcon(int row, bool dark) const;
+    std::function<ComboModel::Snapshot()> snapshotTask() const;
+    int highlightedRow() const;
+    static Popup *sharedPopup();
+    void cancelFilter();
+    void clearFilter();
+    void invalidateFilterIndex();
+    void scheduleRefilter();
+    void refilter();
+    void appendFilterResults(int begin, int end);
+    void finishFilter();
+    void showFilterResults();
+    void connectItemSource();
+    void bindItemSource(QAbstractItemModel *next);
+    const ItemIndex &textIndex() const;
+    void closeItemStream();
+    void onSelectionChanged();
 
     // Flags
     bool isEditable = false;
     bool isIconic = false;
     bool isDarkMode = false;
+    bool isInstantOpen = false;
+    bool hasVariableRows = false;
+    bool isSharedPopup = false;
+    bool isMultiSelectMode = false;
+    bool hadDotIndicator = false;
+    bool hadCheckIndicator = false;
 
     // Max Visible Items
     int _maxVisibleItems = 0;
@@ -87,13 +251,50 @@ class ComboBox : public TextField {
     Button *dropdown = nullptr;
     const QString ArrowDown = IconManager::icon(Icons::ArrowDown);
 
-    // Rounded Popup
-    Popup *popup = nullptr;
+    // Rounded Popup, in shared mode only set while this combo has borrowed it
+    QPointer<Popup> popup;
+    QList<QMetaObject::Connection> popupConnections;
+    int _popupWidth = 0;
+
+    // Prepared Popup Placement
+    bool hasPreparedPlacement = false;
+    QPoint preparedAnchorPos;
+    QSize preparedPopupSize;
+
+    // Open Latency
+    QElapsedTimer openTimer;
+    qint64 _lastOpenLatency = -1;
 
     // List & Delegate for data items inside Popup
     Delegate *delegate = nullptr;
-    QStandardItemModel model;
+    std::shared_ptr<ComboModel> items = std::make_shared<ComboModel>();
+
+    // Rows shown by the popup, the built-in model unless an external one is set
+    QAbstractItemModel *itemSource = nullptr;
+    QPointer<QAbstractItemModel> externalModel;
+
+    // Background Filter (editable mode)
+    ComboFilterModel filterModel;
+    QFuture<std::shared_ptr<const FilterIndex>> filterIndex;
+    QFutureWatcher<std::vector<int>> *filterWatcher = nullptr;
+    QString pendingFilterQuery, lastFilterQuery;
+    std::shared_ptr<const std::vector<int>> lastFilterMatches;
+    bool hasFilterResults = false;
+    QTimer *refilterTimer = nullptr;
+
+    // Follows its row through removals and sorted inserts
+    QPersistentModelIndex currentItem;
+
+    // Items streamed in from a worker thread
+    std::shared_ptr<ItemStream<ComboItem>> itemStream;
+    StreamDrainer *streamDrainer = nullptr;
+
+    // Exact and prefix lookup, also drives type-ahead in non-editable mode. ComboModel sources
+    // lend theirs, so combos sharing a model share one index, the own one serves other models
+    ItemIndex ownIndex;
+    TypeAhead typeAhead;
 
-    // Auto Completer
-    QCompleter *completer = nullptr;
+    // Multi-select membership by source row, selected rows are carried across a reorder
+    SelectionBitset selection;
+    QList<QPersistentModelIndex> layoutSelection;
 };
@@ -0,0 +1,169 @@
+#include "ComboFilterModel.h"
+
+ComboFilterModel::ComboFilterModel(QObject *parent) : QAbstractProxyModel(parent) {}
+
+void ComboFilterModel::setSourceModel(QAbstractItemModel *source) {
+    beginResetModel();
+
+    if (sourceModel()) 
+        disconnect(sourceModel(), nullptr, this, nullptr);
+
+    QAbstractProxyModel::setSourceModel(source);
+    filtering = false;
+    rows.clear();
+
+    if (source) {
+        // Passthrough forwards structural changes 1:1, filtered rows are stale after any change
+        connect(source, &QAbstractItemModel::rowsAboutToBeInserted, this, [this](const QModelIndex &, int first, int last) {
+            dropFilter();
+            beginInsertRows(QModelIndex(), first, last);
+        });
+        connect(source, &QAbstractItemModel::rowsInserted, this, [this]() { endInsertRows(); });
+
+        connect(source, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &, int first, int last) {
+            dropFilter();
+            beginRemoveRows(QModelIndex(), first, last);
+        });
+        connect(source, &QAbstractItemModel::rowsRemoved, this, [this]() { endRemoveRows(); });
+
+        connect(source, &QAbstractItemModel::rowsAboutToBeMoved, this, [this](const QModelIndex &, int first, int last, const QModelIndex &, int destination) {
+            dropFilter();
+            beginMoveRows(QModelIndex(), first, last, QModelIndex(), destination);
+        });
+        connect(source, &QAbstractItemModel::rowsMoved, this, [this]() { endMoveRows(); });
+
+        connect(source, &QAbstractItemModel::modelAboutToBeReset, this, [this]() { beginResetModel(); });
+        connect(source, &QAbstractItemModel::modelReset, this, [this]() {
+            const bool wasFiltering = std::exchange(filtering, false);
+            rows.clear();
+            endResetModel();
+
+            if (wasFiltering) 
+                emit filterDropped();
+        });
+
+        connect(source, &QAbstractItemModel::dataChanged, this, &ComboFilterModel::onSourceDataChanged);
+        connect(source, &QAbstractItemModel::layoutAboutToBeChanged, this, &ComboFilterModel::onSourceLayoutAboutToBeChanged);
+        connect(source, &QAbstractItemModel::layoutChanged, this, &ComboFilterModel::onSourceLayoutChanged);
+    }
+
+    endResetModel();
+}
+
+QModelIndex ComboFilterModel::index(int row, int column, const QModelIndex &parent) const {
+    if (parent.isValid() || column != 0 || row < 0 || row >= rowCount()) 
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex ComboFilterModel::parent(const QModelIndex &) const { return QModelIndex(); }
+
+int ComboFilterModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid() || !sourceModel()) 
+        return 0;
+    return filtering ? int(rows.size()) : sourceModel()->rowCount();
+}
+
+int ComboFilterModel::columnCount(const QModelIndex &parent) const { return parent.isValid() ? 0 : 1; }
+
+QModelIndex ComboFilterModel::mapToSource(const QModelIndex &proxyIndex) const {
+    if (!proxyIndex.isValid() || !sourceModel()) 
+        return QModelIndex();
+    return sourceModel()->index(filtering ? rows[proxyIndex.row()] : proxyIndex.row(), 0);
+}
+
+QModelIndex ComboFilterModel::mapFromSource(const QModelIndex &sourceIndex) const {
+    if (!sourceIndex.isValid()) 
+        return QModelIndex();
+
+    if (!filtering) 
+        return createIndex(sourceIndex.row(), 0);
+
+    auto it = std::lower_bound(rows.begin(), rows.end(), sourceIndex.row());
+    if (it == rows.end() || *it != sourceIndex.row()) 
+        return QModelIndex();
+
+    return createIndex(int(it - rows.begin()), 0);
+}
+
+QVariant ComboFilterModel::data(const QModelIndex &index, int role) const {
+    if (role == Qt::UserRole + 6) 
+        return index.isValid() ? QVariant(mapToSource(index).row()) : QVariant();
+
+    return QAbstractProxyModel::data(index, role);
+}
+
+void ComboFilterModel::clearFilter() {
+    if (!filtering) 
+        return;
+
+    beginResetModel();
+    filtering = false;
+    rows.clear();
+    endResetModel();
+}
+
+void ComboFilterModel::dropFilter() {
+    if (!filtering) 
+        return;
+
+    clearFilter();
+    emit filterDropped();
+}
+
+void ComboFilterModel::beginResults() {
+    beginResetModel();
+    filtering = true;
+    rows.clear();
+    endResetModel();
+}
+
+void ComboFilterModel::appendResults(const std::vector<int> &sourceRows) {
+    if (!filtering || sourceRows.empty()) 
+        return;
+
+    const int first = int(rows.size());
+    beginInsertRows(QModelIndex(), first, first + int(sourceRows.size()) - 1);
+    rows.insert(rows.end(), sourceRows.begin(), sourceRows.end());
+    endInsertRows();
+}
+
+bool ComboFilterModel::isFiltering() const { return filtering; }
+const std::vector<int> &ComboFilterModel::filteredRows() const { return rows; }
+
+void ComboFilterModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles) {
+    if (!filtering) {
+        emit dataChanged(index(topLeft.row(), 0), index(bottomRight.row(), 0), roles);
+        return;
+    }
+
+    auto first = std::lower_bound(rows.begin(), rows.end(), topLeft.row());
+    auto last = std::upper_bound(rows.begin(), rows.end(), bottomRight.row());
+    if (first < last) 
+        emit dataChanged(index(int(first - rows.begin()), 0), index(int(last - rows.begin()) - 1, 0), roles);
+}
+
+void ComboFilterModel::onSourceLayoutAboutToBeChanged() {
+    // Match rows are meaningless once the source reorders
+    dropFilter();
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    layoutProxyIndexes = persistentIndexList();
+    layoutSourceIndexes.clear();
+    for (const QModelIndex &proxyIndex : std::as_const(layoutProxyIndexes)) 
+        layoutSourceIndexes.append(QPersistentModelIndex(mapToSource(proxyIndex)));
+}
+
+void ComboFilterModel::onSourceLayoutChanged() {
+    QModelIndexList to;
+    to.reserve(layoutSourceIndexes.size());
+    for (const QPersistentModelIndex &sourceIndex : std::as_const(layoutSourceIndexes)) 
+        to.append(mapFromSource(sourceIndex));
+
+    changePersistentIndexList(layoutProxyIndexes, to);
+    layoutProxyIndexes.clear();
+    layoutSourceIndexes.clear();
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
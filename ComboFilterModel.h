@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QAbstractProxyModel>
+#include <QModelIndex>
+#include <QVariant>
+#include <QPersistentModelIndex>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Proxy that shows either every source row (passthrough) or a streamed list of matches.
+ * Matches are appended in batches as the background filter produces them.
+ */
+class ComboFilterModel : public QAbstractProxyModel {
+    Q_OBJECT
+
+    public:
+    explicit ComboFilterModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *source) override;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+    /**
+     * @brief Also serves the source row on Qt::UserRole + 6.
+     */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Back to passthrough, all source rows are shown.
+     */
+    void clearFilter();
+
+    /**
+     * @brief Starts a filtered result set with no rows yet.
+     */
+    void beginResults();
+
+    /**
+     * @param sourceRows Ascending and greater than every row appended before.
+     */
+    void appendResults(const std::vector<int> &sourceRows);
+
+    bool isFiltering() const;
+    const std::vector<int> &filteredRows() const;
+
+    signals:
+    /**
+     * @brief A source change made the matches stale, the proxy is back to passthrough.
+     * The query has to run again on the changed rows.
+     */
+    void filterDropped();
+
+    private:
+    void dropFilter();
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onSourceLayoutAboutToBeChanged();
+    void onSourceLayoutChanged();
+
+    bool filtering = false;
+    std::vector<int> rows;
+
+    // Proxy persistent indexes and their source rows across a source layout change
+    QModelIndexList layoutProxyIndexes;
+    QList<QPersistentModelIndex> layoutSourceIndexes;
+};
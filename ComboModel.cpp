@@ -0,0 +1,475 @@
+#include "ComboModel.h"
+#include "CollationSort.h"
+#include "ListDiff.h"
+#include "FilterIndex.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+ComboModel::ComboModel(QObject *parent) : QAbstractListModel(parent) {
+    // Any change to the rows makes the cached filter index stale
+    const auto dropFilterIndex = [this]() { cachedFilterIndex = QFuture<std::shared_ptr<const FilterIndex>>(); };
+    connect(this, &QAbstractItemModel::rowsInserted, this, dropFilterIndex);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, dropFilterIndex);
+    connect(this, &QAbstractItemModel::rowsMoved, this, dropFilterIndex);
+    connect(this, &QAbstractItemModel::layoutChanged, this, dropFilterIndex);
+    connect(this, &QAbstractItemModel::modelReset, this, dropFilterIndex);
+}
+
+int ComboModel::rowCount(const QModelIndex &parent) const { 
+    return parent.isValid() ? 0 : int(rows.size()); 
+}
+
+QVariant ComboModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= int(rows.size())) 
+        return QVariant();
+
+    const Row &r = rows[index.row()];
+
+    switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            return arena.mid(r.offset, r.length);
+
+        case Qt::DecorationRole: {
+            if (!r.iconId) 
+                return QVariant();
+            const IconPair &pair = icons[r.iconId];
+            return QIcon(isDarkMode ? pair.dark : pair.light);
+        }
+
+        case LightIconRole:
+            return icons[r.iconId].light;
+
+        case DarkIconRole:
+            return icons[r.iconId].dark;
+
+        default:
+            return QVariant();
+    }
+}
+
+bool ComboModel::removeRows(int row, int count, const QModelIndex &parent) {
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > int(rows.size())) 
+        return false;
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+
+    for (int i = row; i < row + count; ++i) 
+        deadChars += rows[i].length;
+    rows.erase(rows.begin() + row, rows.begin() + row + count);
+    if (!keys.empty()) 
+        keys.erase(keys.begin() + row, keys.begin() + row + count);
+
+    // Reclaim the arena once most of it is unreferenced
+    if (deadChars > arena.size() / 2) 
+        compact();
+
+    endRemoveRows();
+    return true;
+}
+
+void ComboModel::append(const QString &text, const QString &lightIcon, const QString &darkIcon) {
+    if (_sortMode != InsertionOrder) {
+        insertSorted(text, lightIcon, darkIcon);
+        return;
+    }
+
+    const int row = int(rows.size());
+    beginInsertRows(QModelIndex(), row, row);
+    appendRow(text, lightIcon, darkIcon);
+    endInsertRows();
+}
+
+void ComboModel::append(const QVector<Item> &items) { append<const QVector<Item> &>(items); }
+void ComboModel::append(const QStringList &texts) { append<const QStringList &>(texts); }
+
+void ComboModel::appendRow(const QString &text, const QString &lightIcon, const QString &darkIcon) {
+    rows.push_back(makeRow(text, lightIcon, darkIcon));
+}
+
+ComboModel::Row ComboModel::makeRow(const QString &text, const QString &lightIcon, const QString &darkIcon) {
+    // Icons are only used when both variants are present
+    const quint32 iconId = (!lightIcon.isEmpty() && !darkIcon.isEmpty()) ? internIcon(lightIcon, darkIcon) : 0;
+
+    const Row row = { quint32(arena.size()), quint32(text.size()), iconId };
+    arena.append(text);
+    return row;
+}
+
+void ComboModel::insertSorted(const QString &text, const QString &lightIcon, const QString &darkIcon) {
+    QCollatorSortKey key = collator.sortKey(text);
+
+    // O(log n) placement after equal items, so equal texts keep insertion order
+    const int pos = CollationSort::lowerBound(keys, key, true);
+    if (_sortMode == SortedUnique && pos > 0 && keys[pos - 1].compare(key) == 0) 
+        return;
+
+    beginInsertRows(QModelIndex(), pos, pos);
+    rows.insert(rows.begin() + pos, makeRow(text, lightIcon, darkIcon));
+    keys.insert(keys.begin() + pos, std::move(key));
+    endInsertRows();
+}
+
+void ComboModel::appendSorted(const std::vector<Item> &batch) {
+    if (batch.empty()) 
+        return;
+
+    std::vector<QCollatorSortKey> batchKeys = CollationSort::keys(collator, int(batch.size()), [&batch](int i) { return batch[i].text; });
+    const std::vector<int> order = CollationSort::order(batchKeys);
+
+    // Duplicates are dropped within the batch and against the existing rows
+    std::vector<int> kept;
+    kept.reserve(order.size());
+
+    for (int i : order) {
+        if (_sortMode == SortedUnique) {
+            if (!kept.empty() && batchKeys[kept.back()].compare(batchKeys[i]) == 0) 
+                continue;
+
+            const int pos = CollationSort::lowerBound(keys, batchKeys[i]);
+            if (pos < int(keys.size()) && keys[pos].compare(batchKeys[i]) == 0) 
+                continue;
+        }
+        kept.push_back(i);
+    }
+
+    if (kept.empty()) 
+        return;
+
+    qsizetype chars = 0;
+    for (int i : kept) 
+        chars += batch[i].text.size();
+    reserve(int(rows.size() + kept.size()), int(arena.size() + chars));
+
+    // The sorted batch is appended as one run...
+    const int existing = int(rows.size());
+    beginInsertRows(QModelIndex(), existing, existing + int(kept.size()) - 1);
+    for (int i : kept) {
+        rows.push_back(makeRow(batch[i].text, batch[i].lightIcon, batch[i].darkIcon));
+        keys.push_back(std::move(batchKeys[i]));
+    }
+    endInsertRows();
+
+    // ...and merged with the existing run in one layout change
+    if (existing == 0 || keys[existing - 1].compare(keys[existing]) <= 0) 
+        return;
+
+    std::vector<int> merged(rows.size());
+    std::iota(merged.begin(), merged.end(), 0);
+    std::inplace_merge(merged.begin(), merged.begin() + existing, merged.end(), [this](int a, int b) {
+        return keys[a].compare(keys[b]) < 0;
+    });
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    applyOrder(merged);
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void ComboModel::resort() {
+    keys = CollationSort::keys(collator, int(rows.size()), [this](int i) { return text(i); });
+    const std::vector<int> order = CollationSort::order(keys);
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    applyOrder(order);
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void ComboModel::removeDuplicates() {
+    // Walk runs of equal keys from the back so earlier row numbers stay valid
+    int end = int(keys.size());
+
+    while (end > 1) {
+        int start = end - 1;
+        while (start > 0 && keys[start - 1].compare(keys[end - 1]) == 0) 
+            --start;
+
+        if (end - start > 1) 
+            removeRows(start + 1, end - start - 1);
+        end = start;
+    }
+}
+
+void ComboModel::applyOrder(const std::vector<int> &order) {
+    std::vector<Row> sortedRows;
+    std::vector<QCollatorSortKey> sortedKeys;
+    sortedRows.reserve(order.size());
+    sortedKeys.reserve(order.size());
+
+    std::vector<int> newRowOf(order.size());
+    for (int i = 0; i < int(order.size()); ++i) {
+        sortedRows.push_back(rows[order[i]]);
+        if (!keys.empty()) 
+            sortedKeys.push_back(keys[order[i]]);
+        newRowOf[order[i]] = i;
+    }
+
+    // Keep selections and current items pointing at the same texts
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &idx : from) 
+        to.append(index(newRowOf[idx.row()]));
+    changePersistentIndexList(from, to);
+
+    rows.swap(sortedRows);
+    keys.swap(sortedKeys);
+}
+
+void ComboModel::setSortMode(SortMode mode) {
+    if (mode == _sortMode) 
+        return;
+
+    const SortMode previous = _sortMode;
+    _sortMode = mode;
+
+    if (mode == InsertionOrder) {
+        keys.clear();
+        keys.shrink_to_fit();
+        return;
+    }
+
+    if (previous == InsertionOrder) 
+        resort();
+    if (mode == SortedUnique) 
+        removeDuplicates();
+}
+
+ComboModel::SortMode ComboModel::sortMode() const { return _sortMode; }
+
+void ComboModel::setCollator(const QCollator &value) {
+    collator = value;
+
+    if (_sortMode == InsertionOrder) 
+        return;
+
+    resort();
+    if (_sortMode == SortedUnique) 
+        removeDuplicates();
+}
+
+quint32 ComboModel::internIcon(const QString &lightIcon, const QString &darkIcon) {
+    const QString key = lightIcon + QChar('\n') + darkIcon;
+
+    auto it = iconIds.constFind(key);
+    if (it != iconIds.constEnd()) 
+        return it.value();
+
+    const quint32 id = quint32(icons.size());
+    icons.append({ lightIcon, darkIcon });
+    iconIds.insert(key, id);
+    return id;
+}
+
+void ComboModel::compact() {
+    QString packed;
+    packed.reserve(arena.size() - deadChars);
+
+    for (Row &r : rows) {
+        const quint32 offset = quint32(packed.size());
+        packed.append(QStringView(arena).mid(r.offset, r.length));
+        r.offset = offset;
+    }
+
+    arena = std::move(packed);
+    deadChars = 0;
+}
+
+void ComboModel::remove(int row) { removeRows(row, 1); }
+
+void ComboModel::clear() {
+    beginResetModel();
+    arena.clear();
+    rows.clear();
+    keys.clear();
+    deadChars = 0;
+    icons = { IconPair() };
+    iconIds.clear();
+    endResetModel();
+}
+
+void ComboModel::setItems(const QVector<Item> &items) { replaceRows(std::vector<Item>(items.begin(), items.end())); }
+
+void ComboModel::setItems(const QStringList &texts) {
+    std::vector<Item> items;
+    items.reserve(texts.size());
+    for (const QString &text : texts) 
+        items.push_back(Item{ text });
+    replaceRows(std::move(items));
+}
+
+bool ComboModel::matches(int row, const Item &item) const {
+    const IconPair &pair = icons[rows[row].iconId];
+    const bool hasIcon = !item.lightIcon.isEmpty() && !item.darkIcon.isEmpty();
+
+    return textView(row) == item.text 
+        && (hasIcon ? pair.light == item.lightIcon && pair.dark == item.darkIcon : rows[row].iconId == 0);
+}
+
+QString ComboModel::diffKey(const QString &text, const QString &lightIcon, const QString &darkIcon) const {
+    return text + QChar(0x1F) + lightIcon + QChar(0x1F) + darkIcon;
+}
+
+void ComboModel::replaceRows(std::vector<Item> items) {
+    // Sorted modes diff against the target order
+    if (_sortMode != InsertionOrder && !items.empty()) {
+        std::vector<QCollatorSortKey> itemKeys = CollationSort::keys(collator, int(items.size()), [&items](int i) { return items[i].text; });
+        std::vector<Item> sorted;
+        sorted.reserve(items.size());
+
+        int previous = -1;
+        for (int i : CollationSort::order(itemKeys)) {
+            if (_sortMode == SortedUnique && previous != -1 && itemKeys[previous].compare(itemKeys[i]) == 0) 
+                continue;
+            sorted.push_back(std::move(items[i]));
+            previous = i;
+        }
+        items = std::move(sorted);
+    }
+
+    const auto ops = ListDiff::script(count(), int(items.size()), 
+        [this, &items](int o, int n) { return matches(o, items[n]); },
+        [this](int o) { return diffKey(text(o), icons[rows[o].iconId].light, icons[rows[o].iconId].dark); },
+        [this, &items](int n) {
+            const Item &item = items[n];
+            const bool hasIcon = !item.lightIcon.isEmpty() && !item.darkIcon.isEmpty();
+            return diffKey(item.text, hasIcon ? item.lightIcon : QString(), hasIcon ? item.darkIcon : QString());
+        });
+
+    // Too many edits, one reset is cheaper than thousands of row signals
+    if (!ops) {
+        const SortMode mode = _sortMode;
+        _sortMode = InsertionOrder;
+        clear();
+        append(items);
+        _sortMode = mode;
+        if (_sortMode != InsertionOrder) 
+            keys = CollationSort::keys(collator, count(), [this](int i) { return text(i); });
+        return;
+    }
+
+    for (const ListDiff::Op &op : *ops) {
+        switch (op.type) {
+            case ListDiff::Op::Remove:
+                removeRows(op.row, op.count);
+                break;
+
+            case ListDiff::Op::Insert: {
+                beginInsertRows(QModelIndex(), op.row, op.row + op.count - 1);
+                std::vector<Row> inserted;
+                inserted.reserve(op.count);
+                for (int i = 0; i < op.count; ++i) {
+                    const Item &item = items[op.newIndex + i];
+                    inserted.push_back(makeRow(item.text, item.lightIcon, item.darkIcon));
+                    if (_sortMode != InsertionOrder) 
+                        keys.insert(keys.begin() + op.row + i, collator.sortKey(item.text));
+                }
+                rows.insert(rows.begin() + op.row, inserted.begin(), inserted.end());
+                endInsertRows();
+                break;
+            }
+
+            case ListDiff::Op::Move: {
+                beginMoveRows(QModelIndex(), op.row, op.row, QModelIndex(), op.to);
+                const int to = op.to > op.row ? op.to - 1 : op.to;
+                const Row row = rows[op.row];
+                rows.erase(rows.begin() + op.row);
+                rows.insert(rows.begin() + to, row);
+                if (!keys.empty()) {
+                    QCollatorSortKey key = keys[op.row];
+                    keys.erase(keys.begin() + op.row);
+                    keys.insert(keys.begin() + to, std::move(key));
+                }
+                endMoveRows();
+                break;
+            }
+        }
+    }
+}
+
+void ComboModel::reserve(int rowHint, int charHint) {
+    rows.reserve(rowHint);
+    if (charHint > 0) 
+        arena.reserve(charHint);
+}
+
+void ComboModel::setDarkMode(bool value) { isDarkMode = value; }
+
+void ComboModel::invalidateIcons(int firstRow, int lastRow) {
+    firstRow = std::max(firstRow, 0);
+    lastRow = std::min(lastRow, int(rows.size()) - 1);
+
+    if (icons.size() > 1 && firstRow <= lastRow) 
+        emit dataChanged(index(firstRow), index(lastRow), { Qt::DecorationRole, LightIconRole, DarkIconRole });
+}
+
+int ComboModel::count() const { return int(rows.size()); }
+
+QStringView ComboModel::textView(int row) const {
+    if (row < 0 || row >= int(rows.size())) 
+        return QStringView();
+    return QStringView(arena).mid(rows[row].offset, rows[row].length);
+}
+
+QString ComboModel::text(int row) const { return textView(row).toString(); }
+
+QString ComboModel::lightIcon(int row) const {
+    return (row < 0 || row >= int(rows.size())) ? QString() : icons[rows[row].iconId].light;
+}
+
+QString ComboModel::darkIcon(int row) const {
+    return (row < 0 || row >= int(rows.size())) ? QString() : icons[rows[row].iconId].dark;
+}
+
+ComboModel::Snapshot ComboModel::snapshot() const {
+    Snapshot s;
+    s.arena = arena;
+    s.spans.reserve(rows.size());
+
+    for (const Row &r : rows) 
+        s.spans.push_back({ r.offset, r.length });
+
+    return s;
+}
+
+QFuture<std::shared_ptr<const FilterIndex>> ComboModel::filterIndex() const {
+    if (!cachedFilterIndex.isValid()) {
+        cachedFilterIndex = QtConcurrent::run(QThreadPool::globalInstance(), [s = snapshot()]() {
+            return FilterIndex::build(s);
+        });
+    }
+
+    return cachedFilterIndex;
+}
+
+ItemIndex *ComboModel::itemIndex() {
+    // Keeps itself up to date through this model's signals
+    if (!textIndex) {
+        textIndex = std::make_unique<ItemIndex>();
+        textIndex->setModel(this);
+    }
+    return textIndex.get();
+}
+
+std::shared_ptr<ComboModel> ComboModel::clone() const {
+    auto copy = std::make_shared<ComboModel>();
+    copy->arena = arena;
+    copy->rows = rows;
+    copy->deadChars = deadChars;
+    copy->icons = icons;
+    copy->iconIds = iconIds;
+    copy->isDarkMode = isDarkMode;
+    copy->_sortMode = _sortMode;
+    copy->collator = collator;
+    copy->keys = keys;
+    return copy;
+}
+
+qsizetype ComboModel::memoryUsage() const {
+    qsizetype bytes = arena.capacity() * qsizetype(sizeof(QChar));
+    bytes += qsizetype(rows.capacity() * sizeof(Row));
+
+    for (const IconPair &pair : icons) 
+        bytes += (pair.light.capacity() + pair.dark.capacity()) * qsizetype(sizeof(QChar)) + qsizetype(sizeof(IconPair));
+
+    return bytes;
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QModelIndex>
+#include <QVariant>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <QHash>
+#include <QIcon>
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <QFuture>
+#include <vector>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <memory>
+
+#include "ItemIndex.h"
+
+class FilterIndex;
+
+/**
+ * @brief Flat list model behind ComboBox.
+ * Texts live in one shared string arena and icons are interned as small ids,
+ * so a row costs a fixed 12-byte record instead of a heap item per row.
+ */
+class ComboModel : public QAbstractListModel {
+    Q_OBJECT
+
+    public:
+    enum Roles { LightIconRole = Qt::UserRole + 3, DarkIconRole = Qt::UserRole + 4 };
+
+    struct Item { QString text; QString lightIcon = ""; QString darkIcon = ""; };
+
+    /**
+     * @brief Sorted modes place every insert by binary search over cached collation keys,
+     * SortedUnique also drops items that collate equal to an existing one.
+     */
+    enum SortMode { InsertionOrder, Sorted, SortedUnique };
+
+    /**
+     * @brief Read-only copy of all texts for worker threads. The arena is implicitly shared,
+     * so taking a snapshot only copies the span table.
+     */
+    struct Span { quint32 offset; quint32 length; };
+    struct Snapshot { QString arena; std::vector<Span> spans; };
+
+    explicit ComboModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    void append(const QString &text, const QString &lightIcon = "", const QString &darkIcon = "");
+    void append(const QVector<Item> &items);
+    void append(const QStringList &texts);
+
+    /**
+     * @brief Switching to a sorted mode sorts the existing rows once (in parallel for large lists).
+     */
+    void setSortMode(SortMode mode);
+    SortMode sortMode() const;
+
+    /**
+     * @brief Collation used by the sorted modes, the default follows the system locale.
+     */
+    void setCollator(const QCollator &collator);
+
+    /**
+     * @brief Appends a whole range of Item or QString elements as one insertion.
+     * In a sorted mode the batch is keyed and sorted in parallel, then merged in with one layout change.
+     * Accepts any forward range, including temporaries and containers of move-only wrappers
+     * whose elements dereference to Item.
+     */
+    template <typename Range, typename = std::enable_if_t<!std::is_convertible_v<Range, QString>>>
+    void append(Range &&range);
+    void remove(int row);
+    void clear();
+
+    /**
+     * @brief Replaces all rows with items through a minimal series of row inserts, removes and moves,
+     * so persistent indexes (current item, selection, scroll position) survive. Very different lists
+     * fall back to a reset. In a sorted mode items are sorted (and deduplicated) first.
+     */
+    void setItems(const QVector<Item> &items);
+    void setItems(const QStringList &texts);
+
+    /**
+     * @brief Pre-allocates room for the given number of rows and text characters.
+     */
+    void reserve(int rowHint, int charHint = 0);
+
+    /**
+     * @brief DecorationRole follows the dark or light icon set. Views are not notified,
+     * call invalidateIcons() for the rows actually on screen. ComboBox doesn't use this, its delegate
+     * reads LightIconRole or DarkIconRole by its own theme so combos sharing the model can differ.
+     */
+    void setDarkMode(bool value);
+    void invalidateIcons(int firstRow, int lastRow);
+
+    int count() const;
+    QString text(int row) const;
+    QStringView textView(int row) const;
+    QString lightIcon(int row) const;
+    QString darkIcon(int row) const;
+
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Trigram index over the current texts, built once on the thread pool and handed to every
+     * combo filtering this model. Rebuilt after the rows change.
+     */
+    QFuture<std::shared_ptr<const FilterIndex>> filterIndex() const;
+
+    /**
+     * @brief Exact and prefix text lookup, built on first use and shared by every combo listing this model.
+     */
+    ItemIndex *itemIndex();
+
+    /**
+     * @brief Independent copy. The text arena is implicitly shared until one side changes.
+     */
+    std::shared_ptr<ComboModel> clone() const;
+
+    /**
+     * @brief Approximate heap bytes held by the model.
+     */
+    qsizetype memoryUsage() const;
+
+    private:
+    struct Row { quint32 offset; quint32 length; quint32 iconId; };
+    struct IconPair { QString light; QString dark; };
+
+    void appendRow(const QString &text, const QString &lightIcon, const QString &darkIcon);
+    Row makeRow(const QString &text, const QString &lightIcon, const QString &darkIcon);
+    void insertSorted(const QString &text, const QString &lightIcon, const QString &darkIcon);
+    void appendSorted(const std::vector<Item> &batch);
+    void resort();
+    void removeDuplicates();
+    void applyOrder(const std::vector<int> &order);
+    void replaceRows(std::vector<Item> items);
+    bool matches(int row, const Item &item) const;
+    QString diffKey(const QString &text, const QString &lightIcon, const QString &darkIcon) const;
+
+    static const Item &element(const Item &item) { return item; }
+    static Item element(const QString &text) { return Item{ text }; }
+    template <typename Pointer>
+    static auto element(const Pointer &pointer) -> decltype(element(*pointer)) { return element(*pointer); }
+
+    quint32 internIcon(const QString &lightIcon, const QString &darkIcon);
+    void compact();
+
+    QString arena;
+    std::vector<Row> rows;
+    qsizetype deadChars = 0;
+
+    // Id 0 is reserved for "no icon"
+    QVector<IconPair> icons = { IconPair() };
+    QHash<QString, quint32> iconIds;
+
+    bool isDarkMode = false;
+
+    // Sorting, keys[i] belongs to rows[i] while a sorted mode is active
+    SortMode _sortMode = InsertionOrder;
+    QCollator collator;
+    std::vector<QCollatorSortKey> keys;
+
+    // Shared by all combos listing this model
+    mutable QFuture<std::shared_ptr<const FilterIndex>> cachedFilterIndex;
+    std::unique_ptr<ItemIndex> textIndex;
+};
+
+template <typename Range, typename>
+void ComboModel::append(Range &&range) {
+    using std::begin;
+    using std::end;
+
+    if (_sortMode != InsertionOrder) {
+        std::vector<Item> batch;
+        for (auto it = begin(range); it != end(range); ++it) 
+            batch.push_back(element(*it));
+        appendSorted(batch);
+        return;
+    }
+
+    const auto first = begin(range);
+    const auto last = end(range);
+    const qsizetype added = qsizetype(std::distance(first, last));
+    if (added <= 0) 
+        return;
+
+    qsizetype chars = 0;
+    for (auto it = first; it != last; ++it) 
+        chars += element(*it).text.size();
+    reserve(int(rows.size() + added), int(arena.size() + chars));
+
+    const int row = int(rows.size());
+    beginInsertRows(QModelIndex(), row, row + int(added) - 1);
+    for (auto it = first; it != last; ++it) {
+        const auto &item = element(*it);
+        appendRow(item.text, item.lightIcon, item.darkIcon);
+    }
+    endInsertRows();
+}
@@ -19,7 +19,12 @@ void Delegate::setSelectionCheckIndicator(bool enable) {
         hasDotIndicator = false;
 }
 
+bool Delegate::hasSelectionDotIndicator() const { return hasDotIndicator; }
+bool Delegate::hasSelectionCheckIndicator() const { return hasCheckIndicator; }
+
 void Delegate::setActiveIndex(const QModelIndex &index) { activeIndex = index; }
+void Delegate::setSelection(const SelectionBitset *selection) { this->selection = selection; }
+void Delegate::setAsyncIcons(bool enable) { hasAsyncIcons = enable; }
 
 void Delegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
     painter->save();
@@ -27,13 +32,61 @@ void Delegate::paint(QPainter *painter, const QStyleOptionViewItem &option, cons
     // ----------------- Fetching Data from Index ------------------------
     QString text = index.data(Qt::DisplayRole).toString();
     QString iconPath = index.data(Qt::UserRole + 3).toString();
+    if (isDarkMode) {
+        // Models with a separate dark icon set serve it on UserRole + 4
+        QString darkIconPath = index.data(Qt::UserRole + 4).toString();
+        if (!darkIconPath.isEmpty())
+            iconPath = darkIconPath;
+    }
     QString shortcutText = index.data(Qt::UserRole + 1).toString();
     bool hasSubMenu = index.data(Qt::UserRole + 2).toBool();
+    bool isPlaceholder = index.data(Qt::UserRole + 5).toBool();
+    int rowKind = index.data(Qt::UserRole + 7).toInt();
+    QString subtitle = index.data(Qt::UserRole + 8).toString();
+
+    // Separator, a thin line across the row
+    if (rowKind == SeparatorRow) {
+        const int y = option.rect.y() + option.rect.height() / 2;
+        painter->setPen(QPen(isDarkMode ? QColor("#3A3A3A") : QColor("#E5E5E5"), 1));
+        painter->drawLine(option.rect.left() + 8, y, option.rect.right() - 8, y);
+        painter->restore();
+        return;
+    }
+
+    // Section header, small grey caption that is never hovered or selected
+    if (rowKind == HeaderRow) {
+        QFont headerFont("Segoe UI", 8, QFont::DemiBold);
+        painter->setFont(headerFont);
+        painter->setPen(QColor("#8D8D8D"));
+        painter->drawText(option.rect.adjusted(12, 0, -12, -2), Qt::AlignLeft | Qt::AlignBottom, 
+                          QFontMetrics(headerFont).elidedText(text, Qt::ElideRight, option.rect.width() - 24));
+        painter->restore();
+        return;
+    }
+
+    // Row still loading, draw a skeleton bar instead of text
+    if (isPlaceholder) {
+        QRect bar = option.rect.adjusted(12, 0, -12, 0);
+        bar.setWidth(std::max(bar.width() / 2, 24));
+        bar.setHeight(10);
+        bar.moveTop(option.rect.y() + (option.rect.height() - bar.height()) / 2);
+
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(isDarkMode ? QColor("#383838") : QColor("#EBEBEB"));
+        painter->drawRoundedRect(bar, 5, 5);
+        painter->restore();
+        return;
+    }
 
     // ------------------ States ---------------------------
-    bool isHovered = (index == hoveredIndex);
+    bool isEnabled = option.state & QStyle::State_Enabled;
+    bool isHovered = (hoveredIndex == index) && isEnabled;
     bool isSelected = option.state & QStyle::State_Selected;
-    bool isMouseOver = option.state & QStyle::State_MouseOver;
+    bool isMouseOver = (option.state & QStyle::State_MouseOver) && isEnabled;
+
+    // Disabled items are drawn faded
+    if (!isEnabled)
+        painter->setOpacity(0.4);
 
     // -------------------------- Background  ----------------------------
     QRect fullRec = option.rect;
@@ -44,13 +97,17 @@ void Delegate::paint(QPainter *painter, const QStyleOptionViewItem &option, cons
     painter->drawRoundedRect(fullRec.adjusted(1, 1, -1, -1), 6, 6); // Adjusted for small spacing between items
 
     // Icon geometry
-    const QSize IconSize = QSize(18, 18);
     int iconX = 12;
     int iconY = fullRec.y() + (fullRec.height() - IconSize.height()) / 2;
 
     // -------------------------- Indicators --------------------------------
     // Drawing Dot Indicator
-    bool isActive = (index == activeIndex);
+    bool isActive = (activeIndex == index);
+    if (selection) {
+        const QVariant sourceRow = index.data(Qt::UserRole + 6);
+        isActive = selection->test(sourceRow.isValid() ? sourceRow.toInt() : index.row());
+    }
+
     if (hasDotIndicator && isActive) 
         painter->drawPixmap(iconX, iconY, IconManager::renderSvg(IconManager::icon(Icons::Dot), IconSize));
 
@@ -77,11 +134,20 @@ void Delegate::paint(QPainter *painter, const QStyleOptionViewItem &option, cons
         shortcutW = qMin(fmShortcut.horizontalAdvance(shortcutText), 120);
 
     // ---------------- Items Icon -----------------------------------------------
-    QPixmap icon = IconManager::renderSvg(iconPath, IconSize);
-    if (!icon.isNull() && isIconic) {
+    if (isIconic && !iconPath.isEmpty()) {
+        QPixmap icon = hasAsyncIcons ? IconLoader::instance()->pixmap(iconPath, IconSize) 
+                                     : IconManager::renderSvg(iconPath, IconSize);
+
         if (hasCheckIndicator || hasDotIndicator) 
             iconX = 12 + IconSize.width() + 12;
-        painter->drawPixmap(iconX, iconY, icon);
+
+        if (!icon.isNull()) {
+            painter->drawPixmap(iconX, iconY, icon);
+        } else if (hasAsyncIcons) {
+            // Placeholder while the icon is decoded
+            painter->setBrush(isDarkMode ? QColor("#383838") : QColor("#E5E5E5"));
+            painter->drawRoundedRect(QRect(QPoint(iconX, iconY), IconSize).adjusted(2, 2, -2, -2), 4, 4);
+        }
     }
 
     // -------------- SubMenu Arrow Right Icon -----------------------------------
@@ -102,9 +168,20 @@ void Delegate::paint(QPainter *painter, const QStyleOptionViewItem &option, cons
     QFontMetrics f(font);
     QString elidedText = f.elidedText(text, Qt::ElideRight, tW);
 
+    // Two-line items, title in the upper half and subtitle below
+    if (!subtitle.isEmpty()) {
+        textRect.setHeight(tH / 2 + 1);
+
+        QFont subtitleFont("Segoe UI", 9);
+        QRect subtitleRect(tX, fullRec.y() + tH / 2 + 1, tW, tH / 2 - 1);
+        painter->setFont(subtitleFont);
+        painter->setPen("#8D8D8D");
+        painter->drawText(subtitleRect, Qt::AlignLeft | Qt::AlignTop, QFontMetrics(subtitleFont).elidedText(subtitle, Qt::ElideRight, tW));
+    }
+
     painter->setFont(font);
     painter->setPen( isSelected ? QColor::fromString("#0191DF") : (isDarkMode ? Qt::white : Qt::black));
-    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, elidedText);
+    painter->drawText(textRect, Qt::AlignLeft | (subtitle.isEmpty() ? Qt::AlignVCenter : Qt::AlignBottom), elidedText);
 
     // ----------------- Shortcut Text -----------------------------------------
     QRect shortcutRect(fullRec.right() - shortcutW - 12, tY, shortcutW, tH);
@@ -118,6 +195,46 @@ void Delegate::paint(QPainter *painter, const QStyleOptionViewItem &option, cons
     painter->restore();
 }
 
-QSize Delegate::sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const { 
+void Delegate::prewarm(const QAbstractItemModel *model, int firstRow, int count) const {
+    // Font resolution is cached by Qt after the first lookup
+    QFontMetrics(QFont("Segoe UI", 10, QFont::Medium)).height();
+
+    if (hasDotIndicator || hasCheckIndicator) 
+        IconManager::renderSvg(IconManager::icon(hasCheckIndicator ? Icons::Delegate_Check : Icons::Dot), IconSize);
+
+    if (!model) 
+        return;
+
+    const int lastRow = std::min(firstRow + count, model->rowCount());
+
+    for (int row = std::max(firstRow, 0); row < lastRow; ++row) {
+        QModelIndex index = model->index(row, 0);
+
+        if (isIconic) {
+            QString darkIconPath = isDarkMode ? index.data(Qt::UserRole + 4).toString() : QString();
+            QString iconPath = darkIconPath.isEmpty() ? index.data(Qt::UserRole + 3).toString() : darkIconPath;
+
+            if (hasAsyncIcons)
+                IconLoader::instance()->request(iconPath, IconSize);
+            else
+                IconManager::renderSvg(iconPath, IconSize);
+        }
+
+        if (index.data(Qt::UserRole + 2).toBool()) 
+            IconManager::renderSvg(IconManager::icon(Icons::ArrowRight), IconSize);
+    }
+}
+
+QSize Delegate::sizeHint(const QStyleOptionViewItem &, const QModelIndex &index) const { 
+    switch (index.data(Qt::UserRole + 7).toInt()) {
+        case HeaderRow:    return QSize(m_itemSize.width(), 28);
+        case SeparatorRow: return QSize(m_itemSize.width(), 9);
+        default: break;
+    }
+
+    // Two-line items get room for the subtitle
+    if (!index.data(Qt::UserRole + 8).toString().isEmpty()) 
+        return QSize(m_itemSize.width(), m_itemSize.height() + 18);
+
     return QSize(m_itemSize.width(), m_itemSize.height()); 
 }
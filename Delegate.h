@@ -3,8 +3,10 @@
 #include <QStyledItemDelegate>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPen>
 #include <QStyleOptionViewItem>
 #include <QModelIndex>
+#include <QPersistentModelIndex>
 #include <QIcon>
 #include <QPixmap>
 #include <QFont>
@@ -14,13 +16,23 @@
 #include <QSize>
 #include <QRect>
 #include <QString>
+#include <QAbstractItemModel>
+#include <algorithm>
 
 #include "../../resources/IconManager.h"
+#include "IconLoader.h"
+#include "SelectionBitset.h"
 
 class Delegate : public QStyledItemDelegate {
     Q_OBJECT
 
     public:
+    /**
+     * @brief Served on Qt::UserRole + 7, a two-line item serves its second line on Qt::UserRole + 8.
+     * Heights differ per kind, so lists using them need variable row heights.
+     */
+    enum RowKind { ItemRow = 0, HeaderRow = 1, SeparatorRow = 2 };
+
     explicit Delegate(const QSize& itemSize, QObject *parent = nullptr);
     void setDarkMode(bool value);
     void setIconic(bool value);
@@ -29,18 +41,42 @@ class Delegate : public QStyledItemDelegate {
     void setHoveredIndex(const QModelIndex &index);
     void setSelectionDotIndicator(bool enable);
     void setSelectionCheckIndicator(bool enable);
+    bool hasSelectionDotIndicator() const;
+    bool hasSelectionCheckIndicator() const;
     void setActiveIndex(const QModelIndex &index);
 
+    /**
+     * @brief Multi-select: indicators follow membership in selection (by source row, Qt::UserRole + 6
+     * when the view shows a proxy) instead of the single active index. Pass nullptr to switch back.
+     */
+    void setSelection(const SelectionBitset *selection);
+
+    /**
+     * @brief Item icons are decoded off the GUI thread, a placeholder is drawn until they are ready.
+     */
+    void setAsyncIcons(bool enable);
+
+    /**
+     * @brief Rasterizes icons of the given rows and resolves fonts ahead of the first paint.
+     * With async icons the rows are only queued on the IconLoader.
+     */
+    void prewarm(const QAbstractItemModel *model, int firstRow, int count) const;
+
     QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
     private:
+    inline static const QSize IconSize = QSize(18, 18);
+
     QSize m_itemSize;
-    QModelIndex hoveredIndex, activeIndex;
+    // Persistent, so they follow their rows through inserts, removes and moves
+    QPersistentModelIndex hoveredIndex, activeIndex;
+    const SelectionBitset *selection = nullptr;
 
     bool isDarkMode = false;
     bool isIconic = false;
     bool isMenu = true;
     bool hasDotIndicator = false;
     bool hasCheckIndicator = false;
+    bool hasAsyncIcons = false;
 };
\ No newline at end of file
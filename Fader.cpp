@@ -0,0 +1,95 @@
+#include "Fader.h"
+
+Fader::Fader(QWidget *target, QObject *parent) : QObject(parent ? parent : target), target(target) {
+    animation = new QVariantAnimation(this);
+    animation->setEasingCurve(QEasingCurve::InOutQuad);
+    animation->setDuration(300);
+
+    connect(animation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) { apply(value.toReal()); });
+    connect(animation, &QVariantAnimation::finished, this, &Fader::finish);
+}
+
+bool Fader::supportsWindowOpacity() {
+    // Wayland has no client side window opacity
+    static const bool supported = !QGuiApplication::platformName().startsWith("wayland");
+    return supported;
+}
+
+void Fader::setDuration(int ms) { animation->setDuration(std::max(ms, 0)); }
+void Fader::setLiveContent(bool enable) { isLiveContent = enable; }
+bool Fader::isRunning() const { return animation->state() == QAbstractAnimation::Running; }
+
+void Fader::fadeIn() { begin(0.0, 1.0); }
+void Fader::fadeOut() { begin(1.0, 0.0); }
+
+void Fader::stop() {
+    animation->stop();
+    detach();
+}
+
+void Fader::begin(qreal from, qreal to) {
+    animation->stop();
+
+    if (!target) 
+        return;
+
+    isFadingIn = to > from;
+
+    QWidget *nativeWindow = supportsWindowOpacity() ? OverlayLayer::nativeWindow(target) : nullptr;
+
+    if (nativeWindow != window) 
+        detach();
+
+    if (nativeWindow) {
+        window = nativeWindow;
+    } else if (!effect) {
+        // Attached only for the duration of the fade
+        effect = new SmoothOpacity(target);
+        effect->setSnapshotMode(!isLiveContent);
+        target->setGraphicsEffect(effect);
+    }
+
+    apply(from);
+
+    if (animation->duration() == 0) {
+        apply(to);
+        finish();
+        return;
+    }
+
+    animation->setStartValue(from);
+    animation->setEndValue(to);
+    animation->start();
+}
+
+void Fader::apply(qreal value) {
+    if (window) 
+        window->setWindowOpacity(value);
+    else if (effect) 
+        effect->setOpacity(value);
+}
+
+void Fader::detach() {
+    if (window) 
+        window->setWindowOpacity(1.0);
+    window = nullptr;
+
+    // setGraphicsEffect(nullptr) deletes the effect
+    if (target && effect && target->graphicsEffect() == effect) 
+        target->setGraphicsEffect(nullptr);
+    effect = nullptr;
+}
+
+void Fader::finish() {
+    if (isFadingIn) {
+        detach();
+        emit fadedIn();
+        return;
+    }
+
+    // Keep the faded state until the owner has hidden the widget, so it doesn't flash back.
+    // A pooled window gets its opacity reset when it returns to the pool.
+    window = nullptr;
+    emit fadedOut();
+    detach();
+}
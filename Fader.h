@@ -0,0 +1,54 @@
+#pragma once
+
+#include "SmoothOpacity.h"
+#include "OverlayLayer.h"
+
+#include <QObject>
+#include <QWidget>
+#include <QPointer>
+#include <QVariantAnimation>
+#include <QEasingCurve>
+#include <QGuiApplication>
+#include <algorithm>
+
+/**
+ * @brief Fade in/out for popups and progress widgets.
+ * A popup hosted in its own native window fades through window opacity. Anything else gets a
+ * SmoothOpacity effect that is attached only while the fade runs, in snapshot mode unless the
+ * content is live (keeps animating during the fade).
+ */
+class Fader : public QObject {
+    Q_OBJECT
+
+    public:
+    explicit Fader(QWidget *target, QObject *parent = nullptr);
+
+    void setDuration(int ms);
+    void setLiveContent(bool enable);
+
+    void fadeIn();
+    void fadeOut();
+    void stop();
+
+    bool isRunning() const;
+
+    static bool supportsWindowOpacity();
+
+    signals:
+    void fadedIn();
+    void fadedOut();
+
+    private:
+    void begin(qreal from, qreal to);
+    void apply(qreal value);
+    void finish();
+    void detach();
+
+    QPointer<QWidget> target;
+    QPointer<QWidget> window;
+    QPointer<SmoothOpacity> effect;
+    QVariantAnimation *animation = nullptr;
+
+    bool isLiveContent = false;
+    bool isFadingIn = false;
+};
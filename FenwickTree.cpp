@@ -0,0 +1,139 @@
+#include "FenwickTree.h"
+
+namespace {
+    inline int lowBit(int i) { return i & -i; }
+}
+
+void FenwickTree::assign(std::vector<int> values) {
+    this->values = std::move(values);
+    rebuild();
+}
+
+void FenwickTree::clear() {
+    values.clear();
+    tree.assign(1, 0);
+}
+
+void FenwickTree::rebuild() {
+    // Linear construction, every node passes its sum to its parent once
+    const int n = int(values.size());
+    tree.assign(n + 1, 0);
+
+    for (int i = 1; i <= n; ++i) {
+        tree[i] += values[i - 1];
+        const int parent = i + lowBit(i);
+        if (parent <= n) 
+            tree[parent] += tree[i];
+    }
+}
+
+void FenwickTree::append(int value) {
+    if (tree.empty()) 
+        tree.assign(1, 0);
+
+    values.push_back(value);
+    const int i = int(values.size());
+
+    // The new node covers (i - lowbit(i), i]
+    tree.push_back(value + prefix(i - 1) - prefix(i - lowBit(i)));
+}
+
+void FenwickTree::insert(int index, const std::vector<int> &inserted) {
+    index = std::clamp(index, 0, size());
+
+    if (index == size()) {
+        for (int value : inserted) 
+            append(value);
+        return;
+    }
+
+    values.insert(values.begin() + index, inserted.begin(), inserted.end());
+    rebuild();
+}
+
+void FenwickTree::remove(int index, int count) {
+    if (index < 0 || count <= 0 || index >= size()) 
+        return;
+
+    count = std::min(count, size() - index);
+    values.erase(values.begin() + index, values.begin() + index + count);
+
+    // Dropping the tail leaves the remaining nodes valid
+    if (index == int(values.size())) 
+        tree.resize(values.size() + 1);
+    else 
+        rebuild();
+}
+
+void FenwickTree::move(int first, int count, int destination) {
+    if (first < 0 || count <= 0 || first + count > size() || destination < 0 || destination > size() 
+        || (destination >= first && destination <= first + count)) 
+        return;
+
+    const int begin = std::min(first, destination);
+    const int end = std::max(first + count, destination);
+    const std::vector<int> old(values.begin() + begin, values.begin() + end);
+
+    if (destination > first) 
+        std::rotate(values.begin() + first, values.begin() + first + count, values.begin() + destination);
+    else 
+        std::rotate(values.begin() + destination, values.begin() + first, values.begin() + first + count);
+
+    // Long spans are cheaper to rebuild in one linear pass
+    if (qint64(end - begin) * 32 > size()) {
+        rebuild();
+        return;
+    }
+
+    for (int i = begin; i < end; ++i) {
+        if (values[i] != old[i - begin]) 
+            add(i, qint64(values[i]) - old[i - begin]);
+    }
+}
+
+void FenwickTree::set(int index, int value) {
+    if (index < 0 || index >= size() || values[index] == value) 
+        return;
+
+    add(index, qint64(value) - values[index]);
+    values[index] = value;
+}
+
+int FenwickTree::value(int index) const { return index >= 0 && index < size() ? values[index] : 0; }
+
+int FenwickTree::size() const { return int(values.size()); }
+
+void FenwickTree::add(int index, qint64 delta) {
+    for (int i = index + 1; i < int(tree.size()); i += lowBit(i)) 
+        tree[i] += delta;
+}
+
+qint64 FenwickTree::prefix(int count) const {
+    qint64 sum = 0;
+    for (int i = std::min(count, int(tree.size()) - 1); i > 0; i -= lowBit(i)) 
+        sum += tree[i];
+    return sum;
+}
+
+qint64 FenwickTree::total() const { return prefix(size()); }
+
+int FenwickTree::indexAt(qint64 offset) const {
+    const int n = size();
+    if (n == 0) 
+        return -1;
+
+    // Binary lifting: largest pos with prefix(pos) <= offset
+    int pos = 0;
+    int step = 1;
+    while (step * 2 <= n) 
+        step *= 2;
+
+    for (; step > 0; step /= 2) {
+        if (pos + step <= n && tree[pos + step] <= offset) {
+            pos += step;
+            offset -= tree[pos];
+        }
+    }
+
+    return std::min(pos, n - 1);
+}
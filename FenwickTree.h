@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Prefix sums over row heights. Row-to-offset, offset-to-row and single height changes are O(log n),
+ * appends are O(log n) and inserting or removing rows in the middle rebuilds in O(n) without reading the model again.
+ */
+class FenwickTree {
+    public:
+    void assign(std::vector<int> values);
+    void clear();
+
+    void append(int value);
+    void insert(int index, const std::vector<int> &values);
+    void remove(int index, int count);
+
+    /**
+     * @brief Moves count values starting at first before destination (counted before the move, as in beginMoveRows()).
+     * Only the span between both places changes, short moves cost O(span log n) instead of a rebuild.
+     */
+    void move(int first, int count, int destination);
+
+    void set(int index, int value);
+    int value(int index) const;
+
+    int size() const;
+
+    /**
+     * @brief Sum of the first count values, i.e. the offset of row count.
+     */
+    qint64 prefix(int count) const;
+    qint64 total() const;
+
+    /**
+     * @brief Index whose range [prefix(i), prefix(i + 1)) contains offset, clamped to [0, size() - 1]. -1 when empty.
+     */
+    int indexAt(qint64 offset) const;
+
+    private:
+    void rebuild();
+    void add(int index, qint64 delta);
+
+    std::vector<int> values;
+
+    // 1-based, tree[i] sums values in (i - lowbit(i), i]
+    std::vector<qint64> tree;
+};
@@ -0,0 +1,108 @@
+#include "FilterIndex.h"
+
+QString FilterIndex::fold(QStringView text) {
+    QString result(text.size(), Qt::Uninitialized);
+    QChar *out = result.data();
+
+    for (QChar c : text) 
+        *out++ = c.toCaseFolded();
+
+    return result;
+}
+
+quint64 FilterIndex::trigram(const QChar *c) {
+    return (quint64(c[0].unicode()) << 32) | (quint64(c[1].unicode()) << 16) | quint64(c[2].unicode());
+}
+
+std::shared_ptr<const FilterIndex> FilterIndex::build(const ComboModel::Snapshot &snapshot) {
+    std::shared_ptr<FilterIndex> index(new FilterIndex());
+    index->folded = fold(snapshot.arena);
+    index->spans = snapshot.spans;
+
+    const QChar *data = index->folded.constData();
+
+    for (int row = 0; row < int(index->spans.size()); ++row) {
+        const ComboModel::Span &span = index->spans[row];
+
+        for (quint32 i = 0; i + 3 <= span.length; ++i) {
+            std::vector<int> &rows = index->postings[trigram(data + span.offset + i)];
+
+            // Rows arrive in order, so a repeated trigram within one text is always at the back
+            if (rows.empty() || rows.back() != row) 
+                rows.push_back(row);
+        }
+    }
+
+    return index;
+}
+
+bool FilterIndex::contains(int row, QStringView foldedQuery) const {
+    const ComboModel::Span &span = spans[row];
+    return QStringView(folded).mid(span.offset, span.length).contains(foldedQuery);
+}
+
+void FilterIndex::match(const QString &foldedQuery, const std::vector<int> *candidates, 
+                        QPromise<std::vector<int>> &promise, int batchSize) const {
+    std::vector<int> narrowed;
+    const std::vector<int> *scan = candidates;
+
+    // Every trigram of the query must occur in a matching text
+    if (foldedQuery.size() >= 3) {
+        std::vector<const std::vector<int>*> lists;
+
+        for (qsizetype i = 0; i + 3 <= foldedQuery.size(); ++i) {
+            auto it = postings.constFind(trigram(foldedQuery.constData() + i));
+            if (it == postings.constEnd()) 
+                return;
+            lists.push_back(&it.value());
+        }
+
+        if (candidates) 
+            lists.push_back(candidates);
+
+        std::sort(lists.begin(), lists.end(), [](const std::vector<int> *a, const std::vector<int> *b) {
+            return a->size() < b->size();
+        });
+        lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+        narrowed = *lists.front();
+        for (size_t i = 1; i < lists.size() && !narrowed.empty(); ++i) {
+            if (promise.isCanceled()) 
+                return;
+
+            std::vector<int> next;
+            next.reserve(narrowed.size());
+            std::set_intersection(narrowed.begin(), narrowed.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(next));
+            narrowed.swap(next);
+        }
+
+        scan = &narrowed;
+    }
+
+    std::vector<int> batch;
+    batch.reserve(batchSize);
+
+    auto test = [&](int row) {
+        if (!contains(row, foldedQuery)) 
+            return;
+
+        batch.push_back(row);
+        if (int(batch.size()) >= batchSize) {
+            promise.addResult(std::move(batch));
+            batch = std::vector<int>();
+            batch.reserve(batchSize);
+        }
+    };
+
+    const int total = scan ? int(scan->size()) : rowCount();
+    for (int i = 0; i < total; ++i) {
+        if ((i & 1023) == 0 && promise.isCanceled()) 
+            return;
+        test(scan ? (*scan)[i] : i);
+    }
+
+    if (!batch.empty()) 
+        promise.addResult(std::move(batch));
+}
+
+int FilterIndex::rowCount() const { return int(spans.size()); }
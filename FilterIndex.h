@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QHash>
+#include <QPromise>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+
+#include "ComboModel.h"
+
+/**
+ * @brief Immutable trigram index over ComboModel texts for case-insensitive substring filtering.
+ * Built and queried on worker threads, never touches the model itself.
+ */
+class FilterIndex {
+    public:
+    static std::shared_ptr<const FilterIndex> build(const ComboModel::Snapshot &snapshot);
+
+    /**
+     * @brief One-to-one case folding, so offsets into the folded text stay valid.
+     */
+    static QString fold(QStringView text);
+
+    /**
+     * @brief Streams ascending rows whose text contains foldedQuery, batchSize rows per result.
+     * @param candidates Matches of a shorter query this one extends, or nullptr to search all rows.
+     * Stops early once promise.isCanceled() turns true.
+     */
+    void match(const QString &foldedQuery, const std::vector<int> *candidates, 
+               QPromise<std::vector<int>> &promise, int batchSize = 256) const;
+
+    int rowCount() const;
+
+    private:
+    FilterIndex() = default;
+
+    static quint64 trigram(const QChar *c);
+    bool contains(int row, QStringView foldedQuery) const;
+
+    QString folded;
+    std::vector<ComboModel::Span> spans;
+    QHash<quint64, std::vector<int>> postings;
+};
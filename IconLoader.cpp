@@ -0,0 +1,56 @@
+#include "IconLoader.h"
+
+IconLoader::IconLoader(QObject *parent) : QObject(parent) {
+    // Decoding is cheap per icon, two threads keep up with scrolling without starving other work
+    pool.setMaxThreadCount(2);
+}
+
+IconLoader *IconLoader::instance() {
+    static IconLoader *loader = new IconLoader(qApp);
+    return loader;
+}
+
+QPixmap IconLoader::pixmap(const QString &iconPath, const QSize &size) {
+    if (iconPath.isEmpty()) 
+        return QPixmap();
+
+    QPixmap cached;
+    if (QPixmapCache::find(IconManager::cacheKey(iconPath, size), &cached)) 
+        return cached;
+
+    request(iconPath, size);
+    return QPixmap();
+}
+
+void IconLoader::request(const QString &iconPath, const QSize &size) {
+    if (iconPath.isEmpty()) 
+        return;
+
+    const QString key = IconManager::cacheKey(iconPath, size);
+    if (pending.contains(key) || failed.contains(key) || QPixmapCache::find(key, nullptr)) 
+        return;
+
+    pending.insert(key);
+
+    auto *watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, key, iconPath, size]() {
+        watcher->deleteLater();
+        pending.remove(key);
+
+        const QImage image = watcher->result();
+        if (image.isNull()) {
+            failed.insert(key);
+            return;
+        }
+
+        // QPixmap must be created on the GUI thread
+        QPixmapCache::insert(key, QPixmap::fromImage(image));
+        emit iconReady(iconPath, size);
+    });
+
+    watcher->setFuture(QtConcurrent::run(&pool, [iconPath, size]() {
+        return IconManager::rasterize(iconPath, size);
+    }));
+}
+
+int IconLoader::pendingCount() const { return int(pending.size()); }
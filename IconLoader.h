@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QString>
+#include <QSize>
+#include <QSet>
+#include <QImage>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+
+#include "../../resources/IconManager.h"
+
+/**
+ * @brief Decodes SVG icons on a small worker pool.
+ * Results land in the same QPixmapCache entries IconManager::renderSvg() uses,
+ * so both paths share one cache.
+ */
+class IconLoader : public QObject {
+    Q_OBJECT
+
+    public:
+    static IconLoader *instance();
+
+    /**
+     * @brief Cached pixmap, or a null pixmap while the icon is still being decoded.
+     * A miss queues the icon, iconReady() fires once it can be painted.
+     */
+    QPixmap pixmap(const QString &iconPath, const QSize &size);
+
+    /**
+     * @brief Queues decoding without waiting for the result (used for prefetching).
+     */
+    void request(const QString &iconPath, const QSize &size);
+
+    int pendingCount() const;
+
+    signals:
+    void iconReady(const QString &iconPath, const QSize &size);
+
+    private:
+    explicit IconLoader(QObject *parent = nullptr);
+
+    QThreadPool pool;
+    QSet<QString> pending;
+    QSet<QString> failed;
+};
@@ -0,0 +1,89 @@
+#include "IdleScheduler.h"
+
+IdleScheduler::IdleScheduler(QObject *parent) : QObject(parent) {
+    // A zero timer fires once all pending events have been processed
+    timer.setSingleShot(true);
+    timer.setInterval(0);
+    connect(&timer, &QTimer::timeout, this, &IdleScheduler::runSlice);
+}
+
+IdleScheduler *IdleScheduler::instance() {
+    static IdleScheduler *scheduler = new IdleScheduler(qApp);
+    return scheduler;
+}
+
+void IdleScheduler::schedule(const QString &key, const Job &job, Priority priority, QObject *context) {
+    if (!job) 
+        return;
+
+    cancel(key);
+    queues[priority].append({ key, job, context, context != nullptr, priority });
+
+    if (!timer.isActive()) 
+        timer.start();
+}
+
+void IdleScheduler::cancel(const QString &key) {
+    if (key.isEmpty()) 
+        return;
+
+    for (QVector<Task> &queue : queues) {
+        for (int i = queue.size() - 1; i >= 0; --i) {
+            if (queue[i].key == key) {
+                queue.removeAt(i);
+                ++skipped;
+            }
+        }
+    }
+}
+
+void IdleScheduler::setFrameBudget(int ms) { budget = std::max(ms, 1); }
+int IdleScheduler::frameBudget() const { return budget; }
+
+int IdleScheduler::pendingCount() const {
+    int count = 0;
+    for (const QVector<Task> &queue : queues) 
+        count += queue.size();
+
+    return count;
+}
+
+quint64 IdleScheduler::completedCount() const { return completed; }
+quint64 IdleScheduler::skippedCount() const { return skipped; }
+quint64 IdleScheduler::sliceCount() const { return slices; }
+
+bool IdleScheduler::takeNext(Task &task) {
+    for (QVector<Task> &queue : queues) {
+        while (!queue.isEmpty()) {
+            task = queue.takeFirst();
+
+            // Owner went away before its turn
+            if (task.hasContext && !task.context) {
+                ++skipped;
+                continue;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void IdleScheduler::runSlice() {
+    QElapsedTimer elapsed;
+    elapsed.start();
+    ++slices;
+
+    Task task;
+    while (elapsed.elapsed() < budget && takeNext(task)) {
+        // Unfinished jobs go to the back of their queue for the next slice
+        if (task.job()) 
+            queues[task.priority].append(task);
+        else 
+            ++completed;
+    }
+
+    if (pendingCount() > 0) 
+        timer.start();
+}
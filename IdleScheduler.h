@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QVector>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+#include <algorithm>
+
+/**
+ * @brief Library-wide queue of prewarm jobs run while the event loop is idle.
+ * Jobs run in small slices that stop starting new work once the frame budget is spent,
+ * so input and painting are never held up.
+ */
+class IdleScheduler : public QObject {
+    Q_OBJECT
+
+    public:
+    enum Priority {
+        High,
+        Normal,
+        Low,
+    };
+
+    /**
+     * @brief Return true if the job has more work left, it is then re-queued for another slice.
+     */
+    using Job = std::function<bool()>;
+
+    static IdleScheduler *instance();
+
+    /**
+     * @param key A pending job with the same key is replaced (counted as skipped).
+     * @param context If given, the job is skipped once the context object is destroyed.
+     */
+    void schedule(const QString &key, const Job &job, Priority priority = Normal, QObject *context = nullptr);
+    void cancel(const QString &key);
+
+    /**
+     * @brief Time per slice in milliseconds. Default is 4 ms.
+     */
+    void setFrameBudget(int ms);
+    int frameBudget() const;
+
+    int pendingCount() const;
+    quint64 completedCount() const;
+    quint64 skippedCount() const;
+    quint64 sliceCount() const;
+
+    private:
+    explicit IdleScheduler(QObject *parent = nullptr);
+
+    struct Task {
+        QString key;
+        Job job;
+        QPointer<QObject> context;
+        bool hasContext = false;
+        Priority priority = Normal;
+    };
+
+    void runSlice();
+    bool takeNext(Task &task);
+
+    QVector<Task> queues[Low + 1];
+    QTimer timer;
+
+    int budget = 4;
+    quint64 completed = 0;
+    quint64 skipped = 0;
+    quint64 slices = 0;
+};
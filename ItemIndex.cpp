@@ -0,0 +1,220 @@
+#include "ItemIndex.h"
+
+namespace {
+    // Appended rows stay unsorted up to this many before they are merged in
+    constexpr int MaxTailEntries = 1024;
+
+    bool entryLess(const QString &folded, int row, const QString &otherFolded, int otherRow) {
+        const int order = folded.compare(otherFolded);
+        return order != 0 ? order < 0 : row < otherRow;
+    }
+}
+
+ItemIndex::ItemIndex(QObject *parent) : QObject(parent) {}
+
+void ItemIndex::setModel(QAbstractItemModel *model) {
+    if (_model == model) 
+        return;
+
+    if (_model) 
+        disconnect(_model, nullptr, this, nullptr);
+
+    _model = model;
+    invalidate();
+
+    if (!_model) 
+        return;
+
+    connect(_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) { onRowsInserted(first, last); });
+    connect(_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &, int first, int last) { onRowsAboutToBeRemoved(first, last); });
+    connect(_model, &QAbstractItemModel::rowsMoved, this, &ItemIndex::invalidate);
+    connect(_model, &QAbstractItemModel::layoutChanged, this, &ItemIndex::invalidate);
+    connect(_model, &QAbstractItemModel::modelReset, this, &ItemIndex::invalidate);
+    connect(_model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &, const QModelIndex &, const QList<int> &roles) {
+        if (roles.isEmpty() || roles.contains(Qt::DisplayRole)) 
+            invalidate();
+    });
+}
+
+QAbstractItemModel *ItemIndex::model() const { return _model; }
+
+void ItemIndex::invalidate() {
+    built = false;
+    rowOfText.clear();
+    sorted.clear();
+    tail.clear();
+}
+
+QString ItemIndex::textAt(int row) const { return _model->index(row, 0).data(Qt::DisplayRole).toString(); }
+
+void ItemIndex::ensureBuilt() const {
+    if (!_model) 
+        return;
+
+    if (built) {
+        if (int(tail.size()) <= MaxTailEntries) 
+            return;
+
+        // Merge the appended run into the sorted entries
+        std::sort(tail.begin(), tail.end(), [](const Entry &a, const Entry &b) { return entryLess(a.folded, a.row, b.folded, b.row); });
+        const auto middle = sorted.insert(sorted.end(), std::make_move_iterator(tail.begin()), std::make_move_iterator(tail.end()));
+        std::inplace_merge(sorted.begin(), middle, sorted.end(), [](const Entry &a, const Entry &b) { return entryLess(a.folded, a.row, b.folded, b.row); });
+        tail.clear();
+        return;
+    }
+
+    const int count = _model->rowCount();
+    rowOfText.reserve(count);
+    sorted.reserve(count);
+
+    for (int row = 0; row < count; ++row) {
+        const QString text = textAt(row);
+        if (!rowOfText.contains(text)) 
+            rowOfText.insert(text, row);
+        sorted.push_back({text.toCaseFolded(), row});
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const Entry &a, const Entry &b) { return entryLess(a.folded, a.row, b.folded, b.row); });
+    built = true;
+}
+
+void ItemIndex::shiftRows(int from, int delta) {
+    // Shifting keeps the (folded, row) order of the sorted entries, nothing is re-read from the model
+    for (auto it = rowOfText.begin(); it != rowOfText.end(); ++it) {
+        if (it.value() >= from) 
+            it.value() += delta;
+    }
+
+    for (Entry &entry : sorted) {
+        if (entry.row >= from) 
+            entry.row += delta;
+    }
+
+    for (Entry &entry : tail) {
+        if (entry.row >= from) 
+            entry.row += delta;
+    }
+}
+
+int ItemIndex::firstRowOf(const QString &text, int skipFirst, int skipLast) const {
+    const QString folded = text.toCaseFolded();
+    int best = -1;
+
+    const auto consider = [&](const Entry &entry) {
+        if ((entry.row < skipFirst || entry.row > skipLast) && (best == -1 || entry.row < best) && textAt(entry.row) == text) 
+            best = entry.row;
+    };
+
+    // Equal folded texts are ordered by row, the first exact match outside the range wins
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), folded, [](const Entry &entry, const QString &key) {
+        return entry.folded.compare(key) < 0;
+    });
+    for (; it != sorted.end() && it->folded == folded && best == -1; ++it) 
+        consider(*it);
+
+    for (const Entry &entry : tail) {
+        if (entry.folded == folded) 
+            consider(entry);
+    }
+
+    return best;
+}
+
+void ItemIndex::onRowsInserted(int first, int last) {
+    if (!built) 
+        return;
+
+    // Rows from first on moved down, new rows may now be the first with their text.
+    // Appends move nothing, so repeated addItem() and streamed batches skip the walk
+    const int count = last - first + 1;
+    if (first < _model->rowCount() - count) 
+        shiftRows(first, count);
+
+    for (int row = first; row <= last; ++row) {
+        const QString text = textAt(row);
+        const int known = rowOfText.value(text, -1);
+        if (known == -1 || known > row) 
+            rowOfText.insert(text, row);
+        tail.push_back({text.toCaseFolded(), row});
+    }
+}
+
+void ItemIndex::onRowsAboutToBeRemoved(int first, int last) {
+    if (!built) 
+        return;
+
+    // Texts whose first row goes away fall back to their next row, looked up while the rows still exist
+    QHash<QString, int> nextRows;
+    for (int row = first; row <= last; ++row) {
+        const QString text = textAt(row);
+        if (rowOfText.value(text, -1) != row) 
+            continue;
+
+        rowOfText.remove(text);
+        const int next = firstRowOf(text, first, last);
+        if (next != -1) 
+            nextRows.insert(text, next > last ? next - (last - first + 1) : next);
+    }
+
+    const auto removed = [first, last](const Entry &entry) { return entry.row >= first && entry.row <= last; };
+    tail.erase(std::remove_if(tail.begin(), tail.end(), removed), tail.end());
+    sorted.erase(std::remove_if(sorted.begin(), sorted.end(), removed), sorted.end());
+    if (last + 1 < _model->rowCount()) 
+        shiftRows(last + 1, -(last - first + 1));
+
+    rowOfText.insert(nextRows);
+}
+
+int ItemIndex::find(const QString &text) const {
+    ensureBuilt();
+    return rowOfText.value(text, -1);
+}
+
+int ItemIndex::findPrefix(const QString &prefix, int after) const {
+    if (prefix.isEmpty()) 
+        return -1;
+
+    ensureBuilt();
+    const QString folded = prefix.toCaseFolded();
+
+    // Smallest matching row after 'after', and the smallest overall for wrapping around
+    int next = -1, first = -1;
+    const auto consider = [&](int row) {
+        if (first == -1 || row < first) 
+            first = row;
+        if (row > after && (next == -1 || row < next)) 
+            next = row;
+    };
+
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), folded, [](const Entry &entry, const QString &key) {
+        return entry.folded.compare(key) < 0;
+    });
+    for (; it != sorted.end() && it->folded.startsWith(folded); ++it) 
+        consider(it->row);
+
+    for (const Entry &entry : tail) {
+        if (entry.folded.startsWith(folded)) 
+            consider(entry.row);
+    }
+
+    return next != -1 ? next : first;
+}
+
+int TypeAhead::next(const ItemIndex &index, const QString &keyText, int currentRow) {
+    if (keyText.isEmpty() || !keyText.at(0).isPrint()) 
+        return -1;
+
+    if (!typedTimer.isValid() || typedTimer.elapsed() > QApplication::keyboardInputInterval()) 
+        typed.clear();
+    typedTimer.start();
+
+    typed += keyText;
+
+    // "aaa" cycles through the items starting with "a"
+    const bool repeated = std::all_of(typed.begin(), typed.end(), [this](QChar c) { return c == typed.front(); });
+    if (repeated) 
+        return index.findPrefix(typed.left(1), currentRow);
+
+    // A growing prefix may still match the current row
+    return index.findPrefix(typed, currentRow - 1);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QAbstractItemModel>
+#include <QModelIndex>
+#include <QString>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QApplication>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Lookup structures over the display texts of a list model, built lazily on first use.
+ * Exact text maps to its first row through a hash, case-insensitive prefixes are found by
+ * binary search over the folded texts in sorted order.
+ * Inserted and removed rows are applied in place by shifting the stored row numbers, moves, layout
+ * changes, resets and text edits rebuild on the next lookup.
+ */
+class ItemIndex : public QObject {
+    Q_OBJECT
+
+    public:
+    explicit ItemIndex(QObject *parent = nullptr);
+
+    void setModel(QAbstractItemModel *model);
+    QAbstractItemModel *model() const;
+
+    /**
+     * @brief First row whose text equals text, or -1.
+     */
+    int find(const QString &text) const;
+
+    /**
+     * @brief First row after the given one (wrapping around) whose text starts with prefix, ignoring case. -1 if none.
+     * A binary search finds the matching run, which is then walked whole to find the next row, so the cost
+     * is O(log n + matches). Short prefixes shared by most items (a lone "I" over "Item 1" to "Item 99999")
+     * walk most of the index; there is no per-prefix first-row structure as a trie would have.
+     */
+    int findPrefix(const QString &prefix, int after = -1) const;
+
+    /**
+     * @brief Drops both structures, they are rebuilt on the next lookup.
+     */
+    void invalidate();
+
+    private:
+    struct Entry { QString folded; int row; };
+
+    void ensureBuilt() const;
+    void onRowsInserted(int first, int last);
+    void onRowsAboutToBeRemoved(int first, int last);
+    void shiftRows(int from, int delta);
+    int firstRowOf(const QString &text, int skipFirst, int skipLast) const;
+    QString textAt(int row) const;
+
+    QPointer<QAbstractItemModel> _model;
+
+    mutable bool built = false;
+    mutable QHash<QString, int> rowOfText;
+    mutable std::vector<Entry> sorted;
+
+    // Appended since the last build, scanned linearly until merged
+    mutable std::vector<Entry> tail;
+};
+
+/**
+ * @brief Typed-key state of one view, kept apart from the index so views sharing an index type independently.
+ */
+class TypeAhead {
+    public:
+    /**
+     * @brief Feeds one typed key. Keys typed within QApplication::keyboardInputInterval() build up a prefix,
+     * repeating a single character cycles through the items starting with it.
+     * @return Row to jump to, or -1.
+     */
+    int next(const ItemIndex &index, const QString &keyText, int currentRow);
+
+    private:
+    QString typed;
+    QElapsedTimer typedTimer;
+};
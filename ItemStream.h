@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of items from one worker thread to the GUI.
+ * The producer blocks in push() while the ring is full (backpressure) and calls finish() when done.
+ * The consumer drains with drain() and may close() the stream, after which push() returns false.
+ */
+template <typename T>
+class ItemStream {
+    public:
+    explicit ItemStream(int capacity = 65536) {
+        size_t size = 1;
+        while (size < size_t(std::max(capacity, 2))) 
+            size <<= 1;
+
+        mask = size - 1;
+        slots.reset(new std::optional<T>[size]);
+    }
+
+    ItemStream(const ItemStream &) = delete;
+    ItemStream &operator=(const ItemStream &) = delete;
+
+    // Producer side
+
+    /**
+     * @brief Waits while the ring is full. Returns false once the consumer closed the stream.
+     */
+    bool push(T item) {
+        int spins = 0;
+        while (!tryPush(item)) {
+            if (closed.load(std::memory_order_acquire)) 
+                return false;
+
+            // Spin briefly, then give the GUI thread time to drain
+            if (++spins < 64) 
+                std::this_thread::yield();
+            else 
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    bool tryPush(T &item) {
+        if (closed.load(std::memory_order_acquire)) 
+            return false;
+
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) 
+            return false;
+
+        slots[t & mask].emplace(std::move(item));
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Done marker, the consumer finishes after draining what is left.
+     */
+    void finish() { done.store(true, std::memory_order_release); }
+
+    bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+    // Consumer side
+
+    /**
+     * @brief Moves up to max items into out. Returns the number taken.
+     */
+    int drain(std::vector<T> &out, int max) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t available = tail.load(std::memory_order_acquire) - h;
+        const size_t count = std::min(available, size_t(std::max(max, 0)));
+
+        out.reserve(out.size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            std::optional<T> &slot = slots[(h + i) & mask];
+            out.push_back(std::move(*slot));
+            slot.reset();
+        }
+
+        head.store(h + count, std::memory_order_release);
+        return int(count);
+    }
+
+    /**
+     * @brief True once finish() was called and everything pushed before it was drained.
+     */
+    bool isFinished() const {
+        return done.load(std::memory_order_acquire) && tail.load(std::memory_order_acquire) == head.load(std::memory_order_relaxed);
+    }
+
+    int size() const { return int(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)); }
+    int capacity() const { return int(mask + 1); }
+
+    /**
+     * @brief Stops the producer, pending and later pushes are dropped.
+     */
+    void close() { closed.store(true, std::memory_order_release); }
+
+    private:
+    std::unique_ptr<std::optional<T>[]> slots;
+    size_t mask = 0;
+
+    // Each index is written by one side only, kept on separate cache lines
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<bool> done{false};
+    std::atomic<bool> closed{false};
+};
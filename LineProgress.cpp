@@ -4,12 +4,10 @@ LineProgress::LineProgress(QWidget *parent) : QWidget(parent) {
    hide();   
    setAttribute(Qt::WA_TranslucentBackground, true);
 
-   opacity = new SmoothOpacity;
-   setGraphicsEffect(opacity);    
-
-   animation = new QPropertyAnimation(opacity, "opacity");
-   animation->setDuration(300);
-   animation->setEasingCurve(QEasingCurve::InOutQuad);
+   // Content keeps animating while fading, so no snapshot
+   fader = new Fader(this);
+   fader->setLiveContent(true);
+   connect(fader, &Fader::fadedOut, this, &QWidget::hide);
 
    loadDefaultColors();
 
@@ -41,24 +39,11 @@ void LineProgress::setFixedSize(QSize s) {
 }
 
 void LineProgress::fadeIn() {
-   animation->stop();
-   disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-   animation->setStartValue(0.0);
-   animation->setEndValue(1.0);
-   animation->start();
+   fader->fadeIn();
    show();
 }
 
-void LineProgress::fadeOut() {
-   animation->stop();
-   disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-   animation->setStartValue(1.0);
-   animation->setEndValue(0.0);
-   connect(animation, &QPropertyAnimation::finished, this, [this]() {
-      this->hide();
-   });
-   animation->start();
-}
+void LineProgress::fadeOut() { fader->fadeOut(); }
 
 void LineProgress::setDarkMode(bool value) {
    isDarkMode = value;
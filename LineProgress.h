@@ -1,5 +1,5 @@
 #pragma once
-#include "SmoothOpacity.h"
+#include "Fader.h"
 
 #include <QWidget>
 #include <QPropertyAnimation>
@@ -68,8 +68,7 @@ class LineProgress : public QWidget {
    const int radius = lineHeight / 2;
 
    QTimer *timer = nullptr;   
-   QPropertyAnimation *animation = nullptr;
-   SmoothOpacity *opacity = nullptr;
+   Fader *fader = nullptr;
 
    QString loaderText;
 };
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+/**
+ * @brief Minimal edit scripts between two lists, used to replace ComboBox and Menu contents in place.
+ * Common prefix and suffix are stripped, the rest goes through Myers' O((N + M) D) diff.
+ * Items outside the longest common subsequence whose key reappears become moves.
+ */
+namespace ListDiff {
+    struct Op {
+        enum Type { Remove, Insert, Move };
+
+        Type type;
+        int row;            // Remove / Insert: first row, Move: source row
+        int count = 1;      // Remove / Insert
+        int newIndex = 0;   // Insert: first item of the new list
+        int to = 0;         // Move: destination row, counted before the move like QAbstractItemModel::beginMoveRows()
+    };
+
+    /**
+     * @brief Pairs (oldIndex, newIndex) of a longest common subsequence in ascending order.
+     * Returns nullopt once more than maxEdits inserts and removes would be needed, callers then replace everything.
+     */
+    template <typename Equal>
+    std::optional<std::vector<std::pair<int, int>>> commonSubsequence(int oldCount, int newCount, Equal equal, int maxEdits = 2048) {
+        std::vector<std::pair<int, int>> result;
+
+        int prefix = 0;
+        while (prefix < oldCount && prefix < newCount && equal(prefix, prefix)) 
+            result.emplace_back(prefix, prefix), ++prefix;
+
+        int suffix = 0;
+        while (suffix < oldCount - prefix && suffix < newCount - prefix && equal(oldCount - 1 - suffix, newCount - 1 - suffix)) 
+            ++suffix;
+
+        const int n = oldCount - prefix - suffix;
+        const int m = newCount - prefix - suffix;
+        const int limit = std::min(n + m, maxEdits);
+
+        // Forward pass, trace[d] holds V[-d..d] after d edits
+        std::vector<std::vector<int>> trace;
+        std::vector<int> v(2 * size_t(limit) + 3, 0);
+        const int offset = limit + 1;
+        int edits = -1;
+
+        for (int d = 0; d <= limit && edits < 0; ++d) {
+            for (int k = -d; k <= d; k += 2) {
+                int x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ? v[offset + k + 1] : v[offset + k - 1] + 1;
+                int y = x - k;
+                while (x < n && y < m && equal(prefix + x, prefix + y)) 
+                    ++x, ++y;
+                v[offset + k] = x;
+
+                if (x >= n && y >= m) {
+                    edits = d;
+                    break;
+                }
+            }
+            trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+        }
+
+        if (edits < 0) 
+            return std::nullopt;
+
+        // Backtrack the snakes from the end
+        std::vector<std::pair<int, int>> middle;
+        int x = n, y = m;
+        for (int d = edits; d > 0; --d) {
+            const std::vector<int> &previous = trace[d - 1];
+            const auto at = [&previous, d](int k) { return previous[k + d - 1]; };
+
+            const int k = x - y;
+            const int prevK = (k == -d || (k != d && at(k - 1) < at(k + 1))) ? k + 1 : k - 1;
+            const int prevX = at(prevK);
+            const int prevY = prevX - prevK;
+
+            // Diagonal run after the edit
+            while (x > prevX && y > prevY) {
+                --x, --y;
+                middle.emplace_back(prefix + x, prefix + y);
+            }
+            x = prevX, y = prevY;
+        }
+        while (x > 0 && y > 0) {
+            --x, --y;
+            middle.emplace_back(prefix + x, prefix + y);
+        }
+
+        result.insert(result.end(), middle.rbegin(), middle.rend());
+        for (int i = suffix; i > 0; --i) 
+            result.emplace_back(oldCount - i, newCount - i);
+
+        return result;
+    }
+
+    /**
+     * @brief Ops that turn the old list into the new one when applied in order.
+     * equal decides what stays, key pairs removed and inserted items into moves.
+     */
+    template <typename Equal, typename OldKey, typename NewKey>
+    std::optional<std::vector<Op>> script(int oldCount, int newCount, Equal equal, OldKey oldKey, NewKey newKey, int maxEdits = 2048) {
+        const auto common = commonSubsequence(oldCount, newCount, equal, maxEdits);
+        if (!common) 
+            return std::nullopt;
+
+        // Where each new item comes from: an old index (kept or moved) or -1 for a fresh insert
+        std::vector<int> source(newCount, -1);
+        std::vector<char> kept(oldCount, 0), moved(oldCount, 0);
+        for (const auto &[o, n] : *common) {
+            source[n] = o;
+            kept[o] = 1;
+        }
+
+        QHash<QString, QList<int>> removedByKey;
+        for (int o = oldCount - 1; o >= 0; --o) {
+            if (!kept[o]) 
+                removedByKey[oldKey(o)].append(o);
+        }
+        for (int n = 0; n < newCount; ++n) {
+            if (source[n] != -1) 
+                continue;
+
+            auto it = removedByKey.find(newKey(n));
+            if (it == removedByKey.end() || it->isEmpty()) 
+                continue;
+
+            source[n] = it->takeLast();
+            moved[source[n]] = 1;
+        }
+
+        std::vector<Op> ops;
+        const auto push = [&ops](const Op &op) {
+            // Runs of removes at the same row and inserts at consecutive rows collapse
+            if (!ops.empty()) {
+                Op &last = ops.back();
+                if (op.type == Op::Remove && last.type == Op::Remove && last.row == op.row + op.count) {
+                    last.row = op.row, last.count += op.count;
+                    return;
+                }
+                if (op.type == Op::Insert && last.type == Op::Insert && last.row + last.count == op.row && last.newIndex + last.count == op.newIndex) {
+                    last.count += op.count;
+                    return;
+                }
+            }
+            ops.push_back(op);
+        };
+
+        // Current order, as old indices (-1 for inserted rows)
+        std::vector<int> current;
+        current.reserve(std::max(oldCount, newCount));
+
+        // Removals back to front, so earlier rows keep their numbers
+        for (int o = oldCount - 1; o >= 0; --o) {
+            if (!kept[o] && !moved[o]) 
+                push({ Op::Remove, o, 1 });
+        }
+        for (int o = 0; o < oldCount; ++o) {
+            if (kept[o] || moved[o]) 
+                current.push_back(o);
+        }
+
+        // Rows [0, j) are final, kept rows never move
+        for (int j = 0; j < newCount; ++j) {
+            const int want = source[j];
+
+            // Moved items in front of the next kept one wait at the end
+            while (want != -1 && kept[want] && current[j] != want && moved[current[j]]) {
+                const int item = current[j];
+                push({ Op::Move, j, 1, 0, int(current.size()) });
+                current.erase(current.begin() + j);
+                current.push_back(item);
+            }
+
+            if (want == -1) {
+                push({ Op::Insert, j, 1, j });
+                current.insert(current.begin() + j, -1);
+                continue;
+            }
+
+            if (current[j] == want) 
+                continue;
+
+            const int from = int(std::find(current.begin() + j, current.end(), want) - current.begin());
+            push({ Op::Move, from, 1, 0, j });
+            current.erase(current.begin() + from);
+            current.insert(current.begin() + j, want);
+        }
+
+        return ops;
+    }
+}
@@ -0,0 +1,207 @@
+#include "MappedItemModel.h"
+
+#include <QSaveFile>
+#include <QDebug>
+
+namespace {
+    constexpr char IndexMagic[4] = { 'N', 'V', 'I', 'X' };
+    constexpr quint32 IndexVersion = 1;
+    constexpr qint64 IndexHeaderSize = 4 + 4 + 8 + 8;
+}
+
+MappedItemModel::MappedItemModel(QObject *parent) : QAbstractListModel(parent) {}
+
+QByteArrayView MappedItemModel::Mapping::row(qint64 r) const {
+    // Offsets of a mapped index are only checked here, when their row is read
+    const qint64 begin = qint64(std::min(offsets[r], quint64(size)));
+    qint64 end = qint64(std::min(offsets[r + 1], quint64(size)));
+
+    if (end < begin) 
+        return QByteArrayView();
+
+    // Offsets mark line starts, drop the line break (and a CR of CRLF files)
+    if (end > begin && bytes[end - 1] == '\n') 
+        --end;
+    if (end > begin && bytes[end - 1] == '\r') 
+        --end;
+
+    return QByteArrayView(bytes + begin, end - begin);
+}
+
+bool MappedItemModel::scanOffsets(const char *bytes, qint64 size, std::vector<quint64> &offsets) {
+    offsets.clear();
+    offsets.push_back(0);
+
+    const char *cursor = bytes;
+    const char *end = bytes + size;
+
+    while (cursor < end) {
+        const void *lineBreak = std::memchr(cursor, '\n', size_t(end - cursor));
+        if (!lineBreak) 
+            break;
+
+        cursor = static_cast<const char*>(lineBreak) + 1;
+        offsets.push_back(quint64(cursor - bytes));
+    }
+
+    // Last line without a trailing break
+    if (offsets.back() != quint64(size)) 
+        offsets.push_back(quint64(size));
+
+    return true;
+}
+
+bool MappedItemModel::mapIndex(Mapping &m, const QString &indexPath) {
+    m.indexFile.setFileName(indexPath);
+    if (!m.indexFile.open(QIODevice::ReadOnly))
+        return false;
+
+    const uchar *data = m.indexFile.size() >= IndexHeaderSize ? m.indexFile.map(0, m.indexFile.size()) : nullptr;
+    if (!data) {
+        m.indexFile.close();
+        return false;
+    }
+
+    quint32 version = 0;
+    quint64 fileSize = 0, rows = 0;
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&fileSize, data + 8, sizeof(fileSize));
+    std::memcpy(&rows, data + 16, sizeof(rows));
+
+    // Every row spans at least its line break, so a larger count can only be corrupt (and could overflow below).
+    // The offsets themselves are bounds-checked row by row in Mapping::row(), not here
+    const bool valid = std::memcmp(data, IndexMagic, 4) == 0 
+                    && version == IndexVersion 
+                    && fileSize == quint64(m.size)
+                    && rows <= fileSize
+                    && m.indexFile.size() == IndexHeaderSize + qint64((rows + 1) * sizeof(quint64));
+
+    if (!valid) {
+        m.indexFile.unmap(const_cast<uchar*>(data));
+        m.indexFile.close();
+        return false;
+    }
+
+    m.offsets = reinterpret_cast<const quint64*>(data + IndexHeaderSize);
+    m.rows = qint64(rows);
+    m.indexed = true;
+    return true;
+}
+
+bool MappedItemModel::open(const QString &filePath, const QString &indexPath) {
+    auto m = std::make_shared<Mapping>();
+    m->file.setFileName(filePath);
+
+    if (!m->file.open(QIODevice::ReadOnly)) {
+        qWarning() << "MappedItemModel: cannot open" << filePath;
+        return false;
+    }
+
+    m->size = m->file.size();
+    static const char empty = '\0';
+    m->bytes = m->size > 0 ? reinterpret_cast<const char*>(m->file.map(0, m->size)) : &empty;
+
+    if (!m->bytes) {
+        qWarning() << "MappedItemModel: cannot map" << filePath;
+        return false;
+    }
+
+    const bool indexed = !indexPath.isEmpty() && mapIndex(*m, indexPath);
+
+    // Rebuilding is left to the caller (see isIndexed()), open() never writes files
+    if (!indexPath.isEmpty() && !indexed) 
+        qWarning() << "MappedItemModel: index does not match, scanning" << filePath;
+
+    if (!indexed) {
+        scanOffsets(m->bytes, m->size, m->ownedOffsets);
+        m->offsets = m->ownedOffsets.data();
+        m->rows = qint64(m->ownedOffsets.size()) - 1;
+    }
+
+    beginResetModel();
+    mapping = std::move(m);
+    endResetModel();
+    return true;
+}
+
+void MappedItemModel::close() {
+    beginResetModel();
+    mapping.reset();
+    endResetModel();
+}
+
+bool MappedItemModel::isOpen() const { return mapping != nullptr; }
+bool MappedItemModel::isIndexed() const { return mapping && mapping->indexed; }
+
+bool MappedItemModel::buildIndex(const QString &filePath, const QString &indexPath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) 
+        return false;
+
+    const qint64 size = file.size();
+    static const char empty = '\0';
+    const char *bytes = size > 0 ? reinterpret_cast<const char*>(file.map(0, size)) : &empty;
+    if (!bytes) 
+        return false;
+
+    std::vector<quint64> offsets;
+    scanOffsets(bytes, size, offsets);
+
+    const quint64 fileSize = quint64(size);
+    const quint64 rows = quint64(offsets.size()) - 1;
+
+    QSaveFile out(indexPath);
+    if (!out.open(QIODevice::WriteOnly)) 
+        return false;
+
+    out.write(IndexMagic, 4);
+    out.write(reinterpret_cast<const char*>(&IndexVersion), sizeof(IndexVersion));
+    out.write(reinterpret_cast<const char*>(&fileSize), sizeof(fileSize));
+    out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    out.write(reinterpret_cast<const char*>(offsets.data()), qint64(offsets.size() * sizeof(quint64)));
+
+    return out.commit();
+}
+
+int MappedItemModel::rowCount(const QModelIndex &parent) const {
+    return (parent.isValid() || !mapping) ? 0 : int(std::min<qint64>(mapping->rows, INT_MAX));
+}
+
+QVariant MappedItemModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || !mapping || index.row() >= mapping->rows) 
+        return QVariant();
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) 
+        return QString::fromUtf8(mapping->row(index.row()));
+
+    return QVariant();
+}
+
+QByteArrayView MappedItemModel::rowView(int row) const {
+    if (!mapping || row < 0 || row >= mapping->rows) 
+        return QByteArrayView();
+    return mapping->row(row);
+}
+
+QString MappedItemModel::text(int row) const { return QString::fromUtf8(rowView(row)); }
+
+std::function<ComboModel::Snapshot()> MappedItemModel::snapshotTask() const {
+    std::shared_ptr<const Mapping> m = mapping;
+
+    return [m]() {
+        ComboModel::Snapshot snapshot;
+        if (!m) 
+            return snapshot;
+
+        snapshot.spans.reserve(size_t(m->rows));
+        snapshot.arena.reserve(qsizetype(m->size));
+
+        for (qint64 r = 0; r < m->rows; ++r) {
+            const quint32 offset = quint32(snapshot.arena.size());
+            snapshot.arena.append(QString::fromUtf8(m->row(r)));
+            snapshot.spans.push_back({ offset, quint32(snapshot.arena.size()) - offset });
+        }
+
+        return snapshot;
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QModelIndex>
+#include <QVariant>
+#include <QString>
+#include <QByteArrayView>
+#include <QFile>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#include "ComboModel.h"
+
+/**
+ * @brief Read-only list model over a memory-mapped UTF-8 file, one item per line.
+ * Nothing is copied up front, a row is decoded only when a view asks for it.
+ * With a prebuilt offset index (see buildIndex()) opening only checks the index header against the file,
+ * without one the line offsets are found with a single scan of the mapping.
+ */
+class MappedItemModel : public QAbstractListModel {
+    Q_OBJECT
+
+    public:
+    explicit MappedItemModel(QObject *parent = nullptr);
+
+    /**
+     * @param indexPath Optional index written by buildIndex(). If it doesn't match the file, the file is scanned instead.
+     */
+    bool open(const QString &filePath, const QString &indexPath = QString());
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @brief Whether the open file uses its prebuilt index. If not, call buildIndex() (off the GUI thread) and open again.
+     */
+    bool isIndexed() const;
+
+    /**
+     * @brief Writes the binary line offset index for a UTF-8 file.
+     * Layout: "NVIX", quint32 version, quint64 file size, quint64 row count, then row count + 1 quint64 offsets.
+     * Offsets are stored in host byte order, the index is meant to ship next to the file it was built for.
+     */
+    static bool buildIndex(const QString &filePath, const QString &indexPath);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Raw UTF-8 bytes of a row without the line break, pointing into the mapping.
+     */
+    QByteArrayView rowView(int row) const;
+    QString text(int row) const;
+
+    /**
+     * @brief Produces a ComboModel::Snapshot of all rows. Safe to run on a worker thread,
+     * the mapping stays alive as long as the returned function does.
+     */
+    std::function<ComboModel::Snapshot()> snapshotTask() const;
+
+    private:
+    struct Mapping {
+        QFile file;
+        QFile indexFile;
+        const char *bytes = nullptr;
+        qint64 size = 0;
+
+        // Either points into the mapped index or into ownedOffsets
+        const quint64 *offsets = nullptr;
+        std::vector<quint64> ownedOffsets;
+        qint64 rows = 0;
+        bool indexed = false;
+
+        QByteArrayView row(qint64 r) const;
+    };
+
+    static bool scanOffsets(const char *bytes, qint64 size, std::vector<quint64> &offsets);
+    static bool mapIndex(Mapping &mapping, const QString &indexPath);
+
+    std::shared_ptr<Mapping> mapping;
+};
@@ -1,4 +1,5 @@
 #include "Menu.h"
+#include "ListDiff.h"
 
 MenuItem::MenuItem(const QString &iconPath, const QString &text, const QString &shortcut, bool hasSubMenu) : QStandardItem(text) {
     setData(shortcut, Qt::UserRole + 1);
@@ -6,12 +7,18 @@ MenuItem::MenuItem(const QString &iconPath, const QString &text, const QString &
     setData(iconPath, Qt::UserRole + 3);
 }
 
-Menu::Menu(QWidget *parent) : QListView(parent), _maxVisibleItems(8) {
+Menu::Menu(QWidget *parent) : VariableRowView(parent), _maxVisibleItems(8) {
     setItemSize(QSize(150, 36));
     setMouseTracking(true);
     init();
 }
 
+Menu::~Menu() {
+    // A producer blocked on a full stream must not wait forever
+    closeActionStream();
+    releaseLazySubMenus();
+}
+
 void Menu::init() {
     // Popup
     popup = new RoundedBox(nullptr);
@@ -23,9 +30,11 @@ void Menu::init() {
 
     // Vertical Scroll Bar
     vScroll = new ScrollBar(Qt::Vertical);
+    connect(vScroll, &QScrollBar::valueChanged, this, &Menu::prefetchVisibleRows);
 
     // List Properties
     setModel(&_model);
+    textIndex.setModel(&_model);
     setItemDelegate(_delegate);
     setAutoScroll(true);    
     setViewMode(QListView::ListMode);
@@ -46,17 +55,28 @@ void Menu::init() {
     layout->addSpacing(0);
     layout->addWidget(this, 0, Qt::AlignVCenter);
   
-    // Smooth Opacity
-    smooth_opacity = new SmoothOpacity;
-    popup->setGraphicsEffect(smooth_opacity);
-
-    // Opacity Animation
-    animation = new QPropertyAnimation(smooth_opacity, "opacity");
-    animation->setEasingCurve(QEasingCurve::InOutQuad);
-    animation->setDuration(300);
+    // Fade In & Out
+    fader = new Fader(popup, this);
+    connect(fader, &Fader::fadedOut, this, [this]() {
+        if (!popup) 
+            return;
+
+        popup->hide();
+        OverlayLayer::release(popup);
+        emit closed();
+    });
 
-    // Installing Event Filter
-    qApp->installEventFilter(this);
+    // Action ids, persistent indexes follow rows through moves and sorting
+    connect(&_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) { indexActionRows(first, last); });
+    connect(&_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &, int first, int last) {
+        for (int row = first; row <= last; ++row) {
+            const int id = actionId(_model.item(row));
+            if (id != -1 && actionRows.value(id).row() == row)
+                actionRows.remove(id);
+        }
+    });
+    connect(&_model, &QAbstractItemModel::columnsAboutToBeRemoved, this, [this]() { actionRows.clear(); });
+    connect(&_model, &QAbstractItemModel::modelReset, this, [this]() { actionRows.clear(); });
 
     // Item Clicked Signal Slot
     disconnect(this, &Menu::clicked, this, &Menu::onItemClicked);
@@ -67,89 +87,464 @@ void Menu::init() {
 }
 
 void Menu::fadeIn() {
-    animation->stop();
-    disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-    animation->setStartValue(0.0);
-    animation->setEndValue(1.0);
-    animation->start();
-    if (popup) popup->show();
+    if (popup) {
+        OverlayLayer::ensureHosted(popup, effectiveAnchor());
+        fader->fadeIn();
+        popup->show();
+    }
+
+    PopupManager::instance()->push(popup, nullptr, [this]() { fadeOut(); });
+
+    // The popup window never takes focus, keys are picked up application-wide while open
+    qApp->installEventFilter(this);
 }
 
 void Menu::fadeOut() {
-    animation->stop();
-    disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-    animation->setStartValue(1.0);
-    animation->setEndValue(0.0);
-    connect(animation, &QPropertyAnimation::finished, this, [this]() {
-        if (popup) popup->hide();
+    qApp->removeEventFilter(this);
+    PopupManager::instance()->remove(popup);
+    fader->fadeOut();
+}
+
+MenuItem *Menu::createItem(const MenuAction &menuAction) const {
+    if (!menuAction.shortcut.isEmpty() && menuAction.hasSubMenu) {
+        qCritical() << "Using both shortcut and submenu is not allowed.";
+        return nullptr;
+    }
+
+    auto *item = new MenuItem(isDarkMode ? menuAction.darkIcon : menuAction.lightIcon, 
+                              menuAction.text, menuAction.shortcut, menuAction.hasSubMenu);
+
+    if (menuAction.id != -1)
+        item->setData(menuAction.id, Qt::UserRole + 10);
+    if (!menuAction.keySequence.isEmpty())
+        item->setData(menuAction.keySequence, Qt::UserRole + 11);
+
+    return item;
+}
+
+int Menu::actionId(const QStandardItem *item) {
+    const QVariant id = item->data(Qt::UserRole + 10);
+    return id.isValid() ? id.toInt() : -1;
+}
+
+void Menu::indexActionRows(int first, int last) {
+    for (int row = first; row <= last; ++row) {
+        const int id = actionId(_model.item(row));
+        if (id != -1)
+            actionRows.insert(id, _model.index(row, 0));
+    }
+}
+
+void Menu::addAction(const MenuAction &menuAction) {
+    MenuItem *item = createItem(menuAction);
+    if (!item)
+        return;
+
+    if (_sortMode == ComboModel::InsertionOrder) {
+        _model.appendRow(item);
+        return;
+    }
+
+    // Binary search over the cached keys, rows below move down by one
+    QCollatorSortKey key = collator.sortKey(menuAction.text);
+    const int pos = CollationSort::lowerBound(actionKeys, key, true);
+
+    if (_sortMode == ComboModel::SortedUnique && pos > 0 && actionKeys[pos - 1].compare(key) == 0) {
+        delete item;
+        return;
+    }
+
+    _model.insertRow(pos, item);
+    actionKeys.insert(actionKeys.begin() + pos, std::move(key));
+    shiftSubMenus(pos, 1);
+}
+
+void Menu::addActions(const QVector<MenuAction> &menuActions) { addActions<const QVector<MenuAction> &>(menuActions); }
+
+std::shared_ptr<ItemStream<Menu::MenuAction>> Menu::streamActions(int capacity) {
+    closeActionStream();
+
+    auto stream = std::make_shared<ItemStream<MenuAction>>(capacity);
+    actionStream = stream;
+
+    streamDrainer = new StreamDrainer([this, stream](int maxItems) {
+        std::vector<MenuAction> batch;
+        const int taken = stream->drain(batch, maxItems);
+
+        if (taken == 0)
+            return stream->isFinished() ? -1 : 0;
+
+        addActions(batch);
+        return taken;
+    }, this);
+
+    connect(streamDrainer, &StreamDrainer::finished, this, [this]() {
+        closeActionStream();
+        emit actionsStreamFinished();
     });
-    animation->start();
+
+    streamDrainer->start();
+    return stream;
 }
 
-bool Menu::eventFilter(QObject *o, QEvent *event) {
-    if (event->type() == QEvent::MouseButtonPress) {
-        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
-        QPoint globalPos = mouseEvent->globalPosition().toPoint();
-        QWidget *clickedWidget = QApplication::widgetAt(globalPos);
+void Menu::closeActionStream() {
+    if (actionStream)
+        actionStream->close();
+    actionStream.reset();
 
-        if (popup->isVisible() && !popup->isAncestorOf(clickedWidget)) 
-            fadeOut();
+    if (streamDrainer) {
+        streamDrainer->stop();
+        streamDrainer->deleteLater();
     }
+    streamDrainer = nullptr;
+}
 
-    if (event->type() == QEvent::ApplicationDeactivate)
-        if (popup->isVisible())  
-            fadeOut();
+void Menu::appendItems(const QList<QStandardItem*> &rows) {
+    if (rows.isEmpty())
+        return;
+
+    if (_sortMode != ComboModel::InsertionOrder) {
+        mergeItems(rows);
+        updateMenu();
+        return;
+    }
 
-    return QObject::eventFilter(o, event);
+    // One rowsInserted for the whole batch
+    _model.invisibleRootItem()->appendRows(rows);
+    updateMenu();
 }
 
-void Menu::addAction(const MenuAction &menuAction) {
-    MenuItem *item = new MenuItem(isDarkMode ? menuAction.darkIcon : menuAction.lightIcon, 
-                                 menuAction.text, menuAction.shortcut, menuAction.hasSubMenu);
+void Menu::mergeItems(const QList<QStandardItem*> &rows) {
+    const int existing = _model.rowCount();
+
+    QStringList texts;
+    texts.reserve(rows.size());
+    for (const QStandardItem *item : rows) 
+        texts.append(item->text());
+
+    // New keys are computed and sorted in parallel, existing keys are already in order
+    std::vector<QCollatorSortKey> batchKeys = CollationSort::keys(collator, int(texts.size()), [&texts](int i) { return texts[i]; });
+    const std::vector<int> batchOrder = CollationSort::order(batchKeys);
+
+    // Existing rows come first among equal keys, so only new rows are dropped
+    QList<QStandardItem*> kept;
+    QMap<int, Menu*> keptSubMenus;
+    std::vector<QCollatorSortKey> keptKeys;
+    kept.reserve(rows.size());
+    keptKeys.reserve(rows.size());
+
+    for (int i : batchOrder) {
+        if (_sortMode == ComboModel::SortedUnique) {
+            const int pos = CollationSort::lowerBound(actionKeys, batchKeys[i]);
+            const bool duplicate = (!keptKeys.empty() && keptKeys.back().compare(batchKeys[i]) == 0)
+                                || (pos < int(actionKeys.size()) && actionKeys[pos].compare(batchKeys[i]) == 0);
+
+            if (duplicate) {
+                // A dropped row takes its submenu entry along, a submenu built from the menu tree goes with it
+                if (Menu *dropped = subMenus.take(existing + i); dropped && lazySubMenus.contains(dropped))
+                    releaseSubMenu(dropped);
+
+                delete rows[i];
+                continue;
+            }
+        }
 
-    if (!menuAction.shortcut.isEmpty() && menuAction.hasSubMenu) {
-        qCritical() << "Using both shortcut and submenu is not allowed.";
+        if (Menu *subMenu = subMenus.take(existing + i)) 
+            keptSubMenus[existing + int(kept.size())] = subMenu;
+
+        kept.append(rows[i]);
+        keptKeys.push_back(std::move(batchKeys[i]));
+    }
+
+    if (kept.isEmpty()) 
+        return;
+
+    // The sorted batch is appended as one run...
+    actionKeys.insert(actionKeys.end(), std::make_move_iterator(keptKeys.begin()), std::make_move_iterator(keptKeys.end()));
+    subMenus.insert(keptSubMenus);
+    _model.invisibleRootItem()->appendRows(kept);
+
+    if (existing == 0 || actionKeys[existing - 1].compare(actionKeys[existing]) <= 0) 
         return;
+
+    std::vector<int> merged(actionKeys.size());
+    std::iota(merged.begin(), merged.end(), 0);
+    std::inplace_merge(merged.begin(), merged.begin() + existing, merged.end(), [this](int a, int b) {
+        return actionKeys[a].compare(actionKeys[b]) < 0;
+    });
+
+    // ...and merged with the existing run in one layout change. QStandardItemModel can only
+    // reorder rows by sorting, so each row gets its merged position on an internal role first
+    {
+        const QSignalBlocker blocker(&_model);
+        for (int pos = 0; pos < int(merged.size()); ++pos) 
+            _model.item(merged[pos])->setData(pos, Qt::UserRole + 12);
+    }
+
+    _model.setSortRole(Qt::UserRole + 12);
+    _model.sort(0);
+
+    std::vector<QCollatorSortKey> sortedKeys;
+    QMap<int, Menu*> sortedSubMenus;
+    sortedKeys.reserve(merged.size());
+
+    for (int pos = 0; pos < int(merged.size()); ++pos) {
+        sortedKeys.push_back(std::move(actionKeys[merged[pos]]));
+        if (Menu *subMenu = subMenus.value(merged[pos])) 
+            sortedSubMenus[pos] = subMenu;
+    }
+
+    subMenus = sortedSubMenus;
+    actionKeys = std::move(sortedKeys);
+}
+
+void Menu::shiftSubMenus(int from, int delta) {
+    QMap<int, Menu*> updatedSubMenus;
+
+    for (auto it = subMenus.begin(); it != subMenus.end(); ++it) {
+        int key = it.key();
+        updatedSubMenus[key >= from ? key + delta : key] = it.value();
     }
 
-    _model.appendRow(item);
+    subMenus = updatedSubMenus;
 }
 
 void Menu::removeAction(int index) {
     if (index != -1) {
         _model.removeRow(index);
-        subMenus.remove(index);
-
-        QMap<int, Menu*> updatedSubMenus;
 
-        for (auto it = subMenus.begin(); it != subMenus.end(); ++it) {
-            int key = it.key();
+        // A submenu built from the menu tree goes with its row
+        if (Menu *removed = subMenus.take(index); removed && lazySubMenus.contains(removed))
+            releaseSubMenu(removed);
+        shiftSubMenus(index + 1, -1);
 
-            Menu *menu = it.value();
-            updatedSubMenus[key > index ? key - 1 : key] = menu;
-        }
-
-        subMenus = updatedSubMenus;
+        if (index < int(actionKeys.size())) 
+            actionKeys.erase(actionKeys.begin() + index);
 
         updateMenu();
         update();
     }
 }
 
+QStandardItem *Menu::createDividerItem(Delegate::RowKind kind, const QString &title) {
+    auto *item = new QStandardItem(title);
+    item->setData(kind, Qt::UserRole + 7);
+    item->setFlags(Qt::NoItemFlags);
+
+    setVariableRowHeights(true);
+    return item;
+}
+
+void Menu::addSection(const QString &title) { appendItems({ createDividerItem(Delegate::HeaderRow, title) }); }
+void Menu::addSeparator() { appendItems({ createDividerItem(Delegate::SeparatorRow, QString()) }); }
+
+void Menu::setItemSubtitle(int index, const QString &subtitle) {
+    QStandardItem *item = _model.item(index);
+    if (!item)
+        return;
+
+    item->setData(subtitle, Qt::UserRole + 8);
+    if (!subtitle.isEmpty())
+        setVariableRowHeights(true);
+    updateMenu();
+}
+
+void Menu::setItemEnabled(int index, bool enable) {
+    QStandardItem *item = _model.item(index);
+    if (!item || item->isEnabled() == enable)
+        return;
+
+    item->setEnabled(enable);
+}
+
 void Menu::clearAll() {
     _model.clear();
+    actionKeys.clear();
     update();
 }
 
+bool Menu::matchesAction(int row, const MenuAction &menuAction) const {
+    const QStandardItem *item = _model.item(row);
+
+    return item && item->data(Qt::UserRole + 7).toInt() == Delegate::ItemRow
+        && item->text() == menuAction.text
+        && actionId(item) == menuAction.id
+        && item->data(Qt::UserRole + 1).toString() == menuAction.shortcut
+        && item->data(Qt::UserRole + 2).toBool() == menuAction.hasSubMenu
+        && item->data(Qt::UserRole + 3).toString() == (isDarkMode ? menuAction.darkIcon : menuAction.lightIcon);
+}
+
+void Menu::setActions(const QVector<MenuAction> &menuActions) {
+    // Same validation as addAction()
+    QVector<MenuAction> actions;
+    actions.reserve(menuActions.size());
+    for (const MenuAction &menuAction : menuActions) {
+        if (!menuAction.shortcut.isEmpty() && menuAction.hasSubMenu)
+            qCritical() << "Using both shortcut and submenu is not allowed.";
+        else
+            actions.append(menuAction);
+    }
+
+    // Sorted menus diff against the target order, so submenus and hover survive there too
+    std::vector<QCollatorSortKey> targetKeys;
+    if (_sortMode != ComboModel::InsertionOrder && !actions.isEmpty()) {
+        const std::vector<QCollatorSortKey> itemKeys = CollationSort::keys(collator, int(actions.size()), [&actions](int i) { return actions[i].text; });
+        QVector<MenuAction> sorted;
+        sorted.reserve(actions.size());
+        targetKeys.reserve(itemKeys.size());
+
+        int previous = -1;
+        for (int i : CollationSort::order(itemKeys)) {
+            if (_sortMode == ComboModel::SortedUnique && previous != -1 && itemKeys[previous].compare(itemKeys[i]) == 0) 
+                continue;
+            sorted.append(actions[i]);
+            targetKeys.push_back(itemKeys[i]);
+            previous = i;
+        }
+        actions.swap(sorted);
+    }
+
+    const auto actionKey = [this](const QString &text, const QString &shortcut, const QString &icon, int id) {
+        return text + QChar(0x1F) + shortcut + QChar(0x1F) + icon + QChar(0x1F) + QString::number(id);
+    };
+
+    const auto ops = ListDiff::script(_model.rowCount(), int(actions.size()),
+        [this, &actions](int o, int n) { return matchesAction(o, actions[n]); },
+        [this, &actionKey](int o) {
+            const QStandardItem *item = _model.item(o);
+            return actionKey(item->text(), item->data(Qt::UserRole + 1).toString(), item->data(Qt::UserRole + 3).toString(), actionId(item));
+        },
+        [this, &actions, &actionKey](int n) {
+            const MenuAction &action = actions[n];
+            return actionKey(action.text, action.shortcut, isDarkMode ? action.darkIcon : action.lightIcon, action.id);
+        });
+
+    // Unrelated lists are rebuilt
+    if (!ops) {
+        clearAll();
+        releaseLazySubMenus();
+        subMenus.clear();
+        addActions(actions);
+        return;
+    }
+
+    for (const ListDiff::Op &op : *ops) {
+        switch (op.type) {
+            case ListDiff::Op::Remove:
+                _model.removeRows(op.row, op.count);
+                for (int row = op.row; row < op.row + op.count; ++row) {
+                    if (Menu *removed = subMenus.take(row); removed && lazySubMenus.contains(removed))
+                        releaseSubMenu(removed);
+                }
+                shiftSubMenus(op.row + op.count, -op.count);
+                break;
+
+            case ListDiff::Op::Insert: {
+                QList<QStandardItem*> items;
+                for (int i = 0; i < op.count; ++i)
+                    items.append(createItem(actions[op.newIndex + i]));
+                shiftSubMenus(op.row, op.count);
+                _model.invisibleRootItem()->insertRows(op.row, items);
+                break;
+            }
+
+            case ListDiff::Op::Move: {
+                // QStandardItemModel has no row moves, the row is taken out and put back
+                const int to = op.to > op.row ? op.to - 1 : op.to;
+                const bool wasHovered = hoveredIndex.isValid() && hoveredIndex.row() == op.row;
+                Menu *subMenu = subMenus.take(op.row);
+                shiftSubMenus(op.row + 1, -1);
+                _model.insertRow(to, _model.takeRow(op.row));
+                shiftSubMenus(to, 1);
+                if (subMenu)
+                    subMenus[to] = subMenu;
+                if (wasHovered)
+                    setHoveredIndex(_model.index(to, 0));
+                break;
+            }
+        }
+    }
+
+    // Rows now match the sorted target one to one
+    if (_sortMode != ComboModel::InsertionOrder)
+        actionKeys = std::move(targetKeys);
+
+    updateMenu();
+    update();
+}
+
+void Menu::setSortMode(ComboModel::SortMode mode) {
+    if (_sortMode == mode) 
+        return;
+
+    _sortMode = mode;
+    actionKeys.clear();
+
+    if (_sortMode == ComboModel::InsertionOrder) 
+        return;
+
+    // Existing rows are re-keyed and sorted as one batch, submenus keep their row numbers
+    // since the batch starts at row 0
+    QList<QStandardItem*> rows = _model.rowCount() ? _model.takeColumn(0) : QList<QStandardItem*>();
+    _model.clear();
+
+    mergeItems(rows);
+    updateMenu();
+}
+
+ComboModel::SortMode Menu::sortMode() const { return _sortMode; }
+
+void Menu::setCollator(const QCollator &collator) {
+    this->collator = collator;
+
+    if (_sortMode == ComboModel::InsertionOrder) 
+        return;
+
+    const ComboModel::SortMode mode = _sortMode;
+    _sortMode = ComboModel::InsertionOrder;
+    setSortMode(mode);
+}
+
+void Menu::setPagedModel(PagedModel *model) {
+    pagedModel = model;
+    setModel(model ? static_cast<QAbstractItemModel*>(model) : &_model);
+    setHoveredIndex(QModelIndex());
+
+    if (model && model->rowCount() == 0 && model->canFetchMore(QModelIndex())) 
+        model->fetchMore(QModelIndex());
+
+    updateMenu();
+}
+
+void Menu::prefetchVisibleRows() {
+    if (!pagedModel) 
+        return;
+
+    const QRect area = viewport()->rect();
+    int first = indexAt(area.topLeft()).row();
+    int last = indexAt(QPoint(area.left(), area.bottom())).row();
+
+    if (first < 0) 
+        first = 0;
+    if (last < 0) 
+        last = first + _maxVisibleItems - 1;
+
+    pagedModel->prefetch(first, last);
+}
+
 void Menu::updateMenu() {
     int itemsHeight = sizeHintForRow(0);
-    int totalItems = _model.rowCount(); 
+    int totalItems = model() ? model()->rowCount() : 0; 
     
     if (totalItems <= 0) 
         return;
     
     int visibleItems = std::min(totalItems, _maxVisibleItems);
     int height = (visibleItems * itemsHeight) + spacing() * (visibleItems - 1) + 8;
+
+    // Variable heights, the first visible rows decide
+    if (hasVariableRowHeights())
+        height = rowTop(visibleItems) - spacing() + 8;
     
     setVerticalScrollBarPolicy(totalItems > visibleItems ? Qt::ScrollBarAsNeeded : Qt::ScrollBarAlwaysOff);
     setFixedHeight(height);
@@ -165,6 +560,109 @@ void Menu::setHoveredIndex(const QModelIndex &index) {
     update();
 }
 
+void Menu::setMenuTree(std::vector<MenuNode> nodes) {
+    auto tree = std::make_shared<const std::vector<MenuNode>>(std::move(nodes));
+    setMenuNodes(tree, *tree);
+}
+
+void Menu::setMenuNodes(std::shared_ptr<const std::vector<MenuNode>> tree, const std::vector<MenuNode> &nodes) {
+    releaseLazySubMenus();
+    clearAll();
+    subMenus.clear();
+    setHoveredIndex(QModelIndex());
+
+    // Every level shares the tree, so the node pointers stored on the rows stay valid
+    menuTree = std::move(tree);
+
+    QList<QStandardItem*> rows;
+    rows.reserve(int(nodes.size()));
+
+    for (const MenuNode &node : nodes) {
+        QStandardItem *item = nullptr;
+
+        if (node.kind != Delegate::ItemRow) 
+            item = createDividerItem(node.kind, node.text);
+        else 
+            item = createItem(MenuAction(node.id, node.text, node.children.empty() ? node.shortcut : QString(), 
+                                         node.lightIcon, node.darkIcon, !node.children.empty()));
+
+        item->setData(QVariant::fromValue(quintptr(&node)), Qt::UserRole + 9);
+        rows.append(item);
+    }
+
+    appendItems(rows);
+}
+
+void Menu::ensureSubMenu(const QModelIndex &index) {
+    if (subMenus.contains(index.row()) || !menuTree)
+        return;
+
+    const auto *node = reinterpret_cast<const MenuNode*>(index.data(Qt::UserRole + 9).value<quintptr>());
+    if (!node || node->children.empty())
+        return;
+
+    auto *subMenu = new Menu();
+    subMenu->setParentMenu(this);
+    subMenu->setItemSize(itemSize());
+    subMenu->setMaxVisibleItems(_maxVisibleItems);
+    subMenu->setIconic(isIconic);
+    subMenu->setDarkMode(isDarkMode);
+    subMenu->setReleaseSubMenusOnClose(releaseSubMenusOnClose);
+    subMenu->setMenuNodes(menuTree, node->children);
+
+    // Clicks deep in the tree surface at the root
+    connect(subMenu, &Menu::itemClicked, this, [this, subMenu]() {
+        // The node's callback already ran in the submenu
+        reportClick(subMenu->clickedItemText(), subMenu->clickedItemShortcut(), subMenu->clickedItemIndex(), subMenu->clickedItemId(), nullptr);
+        fadeOut();
+    });
+
+    connect(subMenu, &Menu::closed, this, [this, subMenu]() {
+        if (releaseSubMenusOnClose)
+            releaseSubMenu(subMenu);
+    });
+
+    subMenus[index.row()] = subMenu;
+    lazySubMenus.append(subMenu);
+}
+
+void Menu::releaseSubMenu(Menu *subMenu) {
+    lazySubMenus.removeAll(subMenu);
+
+    for (auto it = subMenus.begin(); it != subMenus.end();) 
+        it = it.value() == subMenu ? subMenus.erase(it) : std::next(it);
+
+    subMenu->releaseLazySubMenus();
+    subMenu->disconnect(this);
+
+    // The popup owns the menu, deleting it takes the whole submenu down
+    RoundedBox *box = subMenu->popup;
+    PopupManager::instance()->remove(box);
+    OverlayLayer::release(box);
+    box->hide();
+    box->deleteLater();
+}
+
+void Menu::releaseLazySubMenus() {
+    const QList<QPointer<Menu>> released = lazySubMenus;
+
+    for (Menu *subMenu : released) {
+        if (subMenu)
+            releaseSubMenu(subMenu);
+    }
+
+    lazySubMenus.clear();
+}
+
+void Menu::setReleaseSubMenusOnClose(bool release) {
+    releaseSubMenusOnClose = release;
+
+    for (Menu *subMenu : lazySubMenus) {
+        if (subMenu)
+            subMenu->setReleaseSubMenusOnClose(release);
+    }
+}
+
 void Menu::addSubMenu(int index, Menu *submenu) {
     if (index != -1 && submenu)
         subMenus[index] = submenu;
@@ -180,7 +678,7 @@ void Menu::move(const QPoint &point) {
     if (!screen) 
         screen = QGuiApplication::primaryScreen();
 
-    popup->move(adjustXY(popup->size(), point, screen->availableGeometry(), false));
+    OverlayLayer::place(popup, effectiveAnchor(), adjustXY(popup->size(), point, screen->availableGeometry(), false));
 }
 
 QPoint Menu::adjustXY(const QSize &s, const QPoint &p, const QRect &screenGeo, bool isSubMenu) {
@@ -206,10 +704,14 @@ QPoint Menu::adjustXY(const QSize &s, const QPoint &p, const QRect &screenGeo, b
 void Menu::hide() { fadeOut(); }
 void Menu::show() {
     updateMenu();
+    prefetchVisibleRows();
     fadeIn();
 }
 
 void Menu::showAt(QWidget *anchorWidget) {
+    if (anchorWidget) 
+        _anchorWidget = anchorWidget;
+
     show();
     
     if (!anchorWidget) 
@@ -255,6 +757,7 @@ QPoint Menu::adjustSubMenuPosition(Menu* subMenu, const QPoint& intendedPos) {
 QString Menu::clickedItemText() const { return _clickedItemText; }
 QString Menu::clickedItemShortcut() const { return _clickedItemShortcut; }
 int Menu::clickedItemIndex() const { return _clickedItemIndex; }
+int Menu::clickedItemId() const { return _clickedItemId; }
 
 void Menu::setItemSize(QSize size) { _itemSize = size.expandedTo(QSize(150, 30)); }
 QSize Menu::itemSize() { return _itemSize; }
@@ -269,9 +772,22 @@ void Menu::setDarkMode(bool value) {
     popup->setDarkMode(isDarkMode);
     _delegate->setDarkMode(isDarkMode);
     vScroll->setDarkMode(isDarkMode);
+
+    for (Menu *subMenu : lazySubMenus) {
+        if (subMenu)
+            subMenu->setDarkMode(isDarkMode);
+    }
 }
 
 void Menu::setParentMenu(Menu *parentMenu) { this->parentMenu = parentMenu; }
+void Menu::setAnchorWidget(QWidget *anchor) { _anchorWidget = anchor; }
+
+QWidget *Menu::effectiveAnchor() const {
+    if (_anchorWidget) 
+        return _anchorWidget;
+
+    return parentMenu ? parentMenu->effectiveAnchor() : nullptr;
+}
 
 void Menu::setMaxVisibleItems(int items) { _maxVisibleItems = items; }
 int Menu::maxVisibleItems() const { return _maxVisibleItems; }
@@ -279,25 +795,35 @@ int Menu::maxVisibleItems() const { return _maxVisibleItems; }
 Delegate *Menu::delegate() const { return _delegate; }
 
 QModelIndex Menu::itemIndex(const QString &itemText) {
-    for (int row = 0; row < _model.rowCount(); ++row) {
-        QModelIndex idx = _model.index(row, 0);
-        if (_model.data(idx).toString() == itemText)
-            return idx;
-    }
+    const int row = textIndex.find(itemText);
+    if (row != -1)
+        return _model.index(row, 0);
 
     qWarning() << "Item is not found in model of menu";
     return QModelIndex();
 }
 
+void Menu::keyboardSearch(const QString &search) {
+    if (model() != &_model)
+        return;
+
+    const int row = typeAhead.next(textIndex, search, hoveredIndex.isValid() ? hoveredIndex.row() : -1);
+    if (row == -1)
+        return;
+
+    const QModelIndex index = _model.index(row, 0);
+    scrollTo(index);
+    setHoveredIndex(index);
+}
+
 void Menu::mouseMoveEvent(QMouseEvent *event) {
     const QModelIndex index = indexAt(event->position().toPoint());
     
     if (!index.isValid()) 
         return;
     
-    QPoint globalPos = mapToGlobal(visualRect(index).topRight()) - QPoint(4,0);
-
     setHoveredIndex(index);
+    ensureSubMenu(index);
 
     if (subMenuTimer) {
         subMenuTimer->stop();
@@ -317,11 +843,8 @@ void Menu::mouseMoveEvent(QMouseEvent *event) {
 
                 connect(subMenuTimer, &QTimer::timeout, [=](){
                     QModelIndex index = indexAt(mapFromGlobal(QCursor::pos()));
-                    if (index.isValid() && index.row() == subMenuIndex) {
-                        subMenu->show();
-                        QPoint adjusted = adjustSubMenuPosition(subMenu, globalPos);
-                        subMenu->move(adjusted);
-                    } 
+                    if (index.isValid() && index.row() == subMenuIndex) 
+                        showSubMenu(subMenuIndex);
                 });
             }
         } else {
@@ -334,6 +857,92 @@ void Menu::mouseMoveEvent(QMouseEvent *event) {
     QListView::mouseMoveEvent(event);
 }
 
+void Menu::showSubMenu(int row) {
+    Menu *subMenu = subMenus.value(row);
+    if (!subMenu || subMenu->isVisible()) 
+        return;
+
+    const QPoint globalPos = mapToGlobal(visualRect(model()->index(row, 0)).topRight()) - QPoint(4,0);
+
+    subMenu->show();
+    subMenu->move(adjustSubMenuPosition(subMenu, globalPos));
+}
+
+void Menu::hoverNextRow(int step) {
+    const int count = model() ? model()->rowCount() : 0;
+    int row = hoveredIndex.isValid() ? hoveredIndex.row() : (step > 0 ? -1 : count);
+
+    // Headers, separators and disabled actions are stepped over
+    for (row += step; row >= 0 && row < count; row += step) {
+        const QModelIndex index = model()->index(row, 0);
+        if (index.flags() & Qt::ItemIsEnabled) {
+            scrollTo(index);
+            setHoveredIndex(index);
+            return;
+        }
+    }
+}
+
+bool Menu::eventFilter(QObject *obj, QEvent *event) {
+    // A key press reaches its QWindow exactly once, before being dispatched to the focus widget
+    if (event->type() != QEvent::KeyPress || !obj->isWindowType() || !popup || !popup->isVisible()) 
+        return VariableRowView::eventFilter(obj, event);
+
+    // Only the innermost open menu takes keys
+    for (Menu *subMenu : subMenus) 
+        if (subMenu && subMenu->isVisible()) 
+            return VariableRowView::eventFilter(obj, event);
+
+    auto *keyEvent = static_cast<QKeyEvent*>(event);
+
+    switch (keyEvent->key()) {
+        case Qt::Key_Up:
+        case Qt::Key_Down:
+            hoverNextRow(keyEvent->key() == Qt::Key_Down ? 1 : -1);
+            return true;
+
+        case Qt::Key_Right:
+        case Qt::Key_Return:
+        case Qt::Key_Enter: {
+            if (!hoveredIndex.isValid()) 
+                return true;
+
+            if (!hoveredIndex.data(Qt::UserRole + 2).toBool()) {
+                if (keyEvent->key() != Qt::Key_Right) 
+                    onItemClicked(hoveredIndex);
+                return true;
+            }
+
+            // Opening a submenu from the keyboard hovers its first action
+            ensureSubMenu(hoveredIndex);
+            if (Menu *subMenu = subMenus.value(hoveredIndex.row()); subMenu && !subMenu->isVisible()) {
+                showSubMenu(hoveredIndex.row());
+                subMenu->hoverNextRow(1);
+            }
+            return true;
+        }
+
+        case Qt::Key_Left:
+            if (parentMenu) 
+                fadeOut();
+            return true;
+
+        case Qt::Key_Escape:
+            fadeOut();
+            return true;
+
+        default: break;
+    }
+
+    const QString text = keyEvent->text();
+    if (!text.isEmpty() && text.at(0).isPrint() && !(keyEvent->modifiers() & (Qt::ControlModifier | Qt::AltModifier | Qt::MetaModifier))) {
+        keyboardSearch(text);
+        return true;
+    }
+
+    return VariableRowView::eventFilter(obj, event);
+}
+
 void Menu::leaveEvent(QEvent *event) {
    QTimer::singleShot(200, [this](){
      bool stillHovering = false;
@@ -351,6 +960,9 @@ void Menu::leaveEvent(QEvent *event) {
 }
 
 void Menu::onItemClicked(const QModelIndex &index) {
+    if (!(index.flags() & Qt::ItemIsEnabled))
+        return;
+
     int idx = index.row();
 
     _delegate->setActiveIndex(index); // Passing it for dot or check indicator
@@ -359,10 +971,94 @@ void Menu::onItemClicked(const QModelIndex &index) {
     if (hasSubMenu) 
         return;
 
-    _clickedItemText = index.data(Qt::DisplayRole).toString();
-    _clickedItemIndex = idx;
-    _clickedItemShortcut = index.data(Qt::UserRole + 1).toString();
+    const QVariant id = index.data(Qt::UserRole + 10);
 
-    emit itemClicked();
+    reportClick(index.data(Qt::DisplayRole).toString(), index.data(Qt::UserRole + 1).toString(), idx, 
+                id.isValid() ? id.toInt() : -1, reinterpret_cast<const MenuNode*>(index.data(Qt::UserRole + 9).value<quintptr>()));
     fadeOut();
 }
+
+void Menu::reportClick(const QString &text, const QString &shortcut, int row, int id, const MenuNode *node) {
+    _clickedItemText = text;
+    _clickedItemShortcut = shortcut;
+    _clickedItemIndex = row;
+    _clickedItemId = id;
+
+    if (node && node->triggered)
+        node->triggered();
+
+    emit itemClicked();
+
+    if (id != -1)
+        emit actionTriggered(id);
+}
+
+QModelIndex Menu::actionIndex(int id) const { return actionRows.value(id); }
+
+void Menu::setActionEnabled(int id, bool enable) {
+    const QModelIndex index = actionIndex(id);
+    if (index.isValid())
+        setItemEnabled(index.row(), enable);
+}
+
+void Menu::triggerAction(int id) {
+    const QModelIndex index = actionIndex(id);
+    if (!index.isValid() || !(index.flags() & Qt::ItemIsEnabled) || index.data(Qt::UserRole + 2).toBool())
+        return;
+
+    reportClick(index.data(Qt::DisplayRole).toString(), index.data(Qt::UserRole + 1).toString(), index.row(), id,
+                reinterpret_cast<const MenuNode*>(index.data(Qt::UserRole + 9).value<quintptr>()));
+}
+
+void Menu::registerShortcuts(QWidget *scope) {
+    // Registering again replaces the menu's previous bindings
+    ShortcutRegistry *registry = ShortcutRegistry::instance();
+    registry->removeOwner(this);
+    QPointer<Menu> menu = this;
+
+    // A sequence can only be bound once, the clash is reported instead of silently doing nothing
+    const auto bind = [&](const QKeySequence &sequence, int id, const ShortcutRegistry::Handler &handler) {
+        if (!registry->add(sequence, handler, this, scope))
+            qWarning() << "Shortcut" << sequence.toString() << "of action" << id << "is already taken.";
+    };
+
+    for (int row = 0; row < _model.rowCount(); ++row) {
+        const QStandardItem *item = _model.item(row);
+        const int id = actionId(item);
+        const QKeySequence sequence = item->data(Qt::UserRole + 11).value<QKeySequence>();
+
+        if (id != -1 && !sequence.isEmpty())
+            bind(sequence, id, [menu, id]() { if (menu) menu->triggerAction(id); });
+    }
+
+    if (!menuTree)
+        return;
+
+    // Nodes below the top level have no rows until their submenu is built, they report straight to this menu.
+    // Submenus list their nodes in order, so the node's place in its level is the row it will have
+    std::function<void(const std::vector<MenuNode> &)> addNodes = [&](const std::vector<MenuNode> &nodes) {
+        for (int row = 0; row < int(nodes.size()); ++row) {
+            const MenuNode &node = nodes[row];
+            if (!node.children.empty()) {
+                addNodes(node.children);
+                continue;
+            }
+
+            const QKeySequence sequence = ShortcutRegistry::parse(node.shortcut);
+            if (node.id == -1 || sequence.isEmpty() || node.kind != Delegate::ItemRow)
+                continue;
+
+            // The handler holds the tree, a later setMenuTree() can't free the node under it
+            bind(sequence, node.id, [menu, tree = menuTree, target = &node, row]() {
+                if (menu)
+                    menu->reportClick(target->text, target->shortcut, row, target->id, target);
+            });
+        }
+    };
+
+    for (int row = 0; row < _model.rowCount(); ++row) {
+        const auto *node = reinterpret_cast<const MenuNode*>(_model.item(row)->data(Qt::UserRole + 9).value<quintptr>());
+        if (node)
+            addNodes(node->children);
+    }
+}
@@ -3,12 +3,23 @@
 #include "ScrollBar.h"
 #include "RoundedBox.h"
 #include "Delegate.h"
-#include "SmoothOpacity.h"
+#include "Fader.h"
+#include "PopupManager.h"
+#include "OverlayLayer.h"
+#include "PagedModel.h"
+#include "VariableRowView.h"
+#include "ComboModel.h"
+#include "CollationSort.h"
+#include "ItemIndex.h"
+#include "ItemStream.h"
+#include "StreamDrainer.h"
+#include "ShortcutRegistry.h"
 
 #include <QStandardItem>
 #include <QListView>
 #include <QStandardItemModel>
 #include <QMouseEvent>
+#include <QKeyEvent>
 #include <QApplication>
 #include <QGuiApplication>
 #include <QScreen>
@@ -22,15 +33,25 @@
 #include <QTimer>
 #include <QCursor>
 #include <QMap>
+#include <QPointer>
+#include <QSignalBlocker>
+#include <QPersistentModelIndex>
+#include <QKeySequence>
+#include <QHash>
 #include <QEvent>
+#include <QCollator>
+#include <QCollatorSortKey>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
 
 class MenuItem : public QStandardItem {
    public:
    explicit MenuItem(const QString &iconPath, const QString &text, const QString &shortcut, bool hasSubMenu);
 };
 
-class Menu : public QListView {
+class Menu : public VariableRowView {
    Q_OBJECT
 
    public:
@@ -40,6 +61,8 @@ class Menu : public QListView {
       const QString shortcut = QString(); 
       const QString lightIcon = QString();
       const QString darkIcon = QString();
+      const int id = -1;
+      const QKeySequence keySequence = ShortcutRegistry::parse(shortcut);
 
       MenuAction(const QString &actionText, const QString &actionShortcut) 
          : text(actionText), shortcut(actionShortcut) {}
@@ -47,10 +70,47 @@ class Menu : public QListView {
       MenuAction(const QString &actionText) : text(actionText){}
 
       MenuAction(const QString &actionText, bool hasSubmenu, const QString &shortcutText, const QString &iconLight, const QString &iconDark) : text(actionText), hasSubMenu(hasSubmenu), shortcut(shortcutText), lightIcon(iconLight), darkIcon(iconDark) {}
+
+      MenuAction(int actionId, const QString &actionText, const QString &shortcutText = QString(), const QString &iconLight = QString(), const QString &iconDark = QString(), bool hasSubmenu = false) 
+         : text(actionText), hasSubMenu(hasSubmenu), shortcut(shortcutText), lightIcon(iconLight), darkIcon(iconDark), id(actionId) {}
       
    }; 
 
+   /**
+    * @brief One row of a menu tree, see setMenuTree(). Nodes with children open a submenu,
+    * their shortcut is ignored.
+    */
+   struct MenuNode {
+      QString text;
+      QString shortcut;
+      QString lightIcon;
+      QString darkIcon;
+      Delegate::RowKind kind = Delegate::ItemRow;
+      int id = -1;
+      std::function<void()> triggered;
+      std::vector<MenuNode> children;
+
+      MenuNode(const QString &nodeText, std::vector<MenuNode> nodeChildren) 
+         : text(nodeText), children(std::move(nodeChildren)) {}
+
+      MenuNode(const QString &nodeText, const QString &nodeShortcut = QString(), std::function<void()> onTriggered = {}) 
+         : text(nodeText), shortcut(nodeShortcut), triggered(std::move(onTriggered)) {}
+
+      static MenuNode section(const QString &title) {
+         MenuNode node(title);
+         node.kind = Delegate::HeaderRow;
+         return node;
+      }
+
+      static MenuNode separator() {
+         MenuNode node{ QString() };
+         node.kind = Delegate::SeparatorRow;
+         return node;
+      }
+   };
+
    explicit Menu(QWidget *parent = nullptr);
+   ~Menu() override;
 
    void fadeIn();
    void fadeOut();
@@ -65,12 +125,84 @@ class Menu : public QListView {
     */
    void addAction(const MenuAction &menuAction);
 
+   /**
+    * @brief Appends all actions as a single model insertion and relayouts the menu once.
+    */
+   void addActions(const QVector<MenuAction> &menuActions);
+
+   /**
+    * @brief Same as above for any range of MenuAction, including temporaries.
+    */
+   template <typename Range>
+   void addActions(Range &&menuActions) {
+      QList<QStandardItem*> rows;
+      for (const MenuAction &menuAction : menuActions) {
+         if (MenuItem *item = createItem(menuAction))
+            rows.append(item);
+      }
+      appendItems(rows);
+   }
+
+   /**
+    * @brief Opens a stream that one worker thread pushes actions into, see ComboBox::streamItems().
+    * actionsStreamFinished() is emitted once finish() was called and the last action is in.
+    */
+   std::shared_ptr<ItemStream<MenuAction>> streamActions(int capacity = 65536);
+
+   /**
+    * @brief Section caption and separator rows. They can't be hovered or clicked and
+    * switch the menu to variable row heights.
+    */
+   void addSection(const QString &title);
+   void addSeparator();
+
+   /**
+    * @brief Second line under the action's text, the row grows to fit it.
+    */
+   void setItemSubtitle(int index, const QString &subtitle);
+
    /**
     * @brief Specify the index of the item which you want to remove.
     */
    void removeAction(int index);
    void clearAll();
 
+   /**
+    * @brief Replaces the actions in place: only rows that differ are inserted, removed or moved,
+    * submenus follow their rows and the hovered item stays hovered. Sorted menus diff against the sorted list.
+    */
+   void setActions(const QVector<MenuAction> &menuActions);
+
+   /**
+    * @brief Keeps actions in collation order, SortedUnique drops actions whose text collates equal.
+    * Submenus follow their rows.
+    */
+   void setSortMode(ComboModel::SortMode mode);
+   ComboModel::SortMode sortMode() const;
+   void setCollator(const QCollator &collator);
+
+   /**
+    * @brief Shows the rows of a paged model instead of the menu's own actions.
+    * Pages around the visible rows are loaded as the menu scrolls. Pass nullptr to switch back.
+    */
+   void setPagedModel(PagedModel *model);
+
+   /**
+    * @brief Disabled items stay in place but are greyed out and ignore clicks.
+    */
+   void setItemEnabled(int index, bool enable);
+
+   /**
+    * @brief Replaces the actions with the top level of the tree. A submenu's Menu is only built
+    * when its row is first hovered, clicks anywhere in the tree are reported by this menu's itemClicked().
+    */
+   void setMenuTree(std::vector<MenuNode> nodes);
+
+   /**
+    * @brief Submenus built from the menu tree are destroyed once they close and rebuilt on the next hover.
+    */
+   void setReleaseSubMenusOnClose(bool release);
+
    /**
     * @attention Must pass the parent menu to setParentMenu() whenever you add a submenu
     */
@@ -89,7 +221,36 @@ class Menu : public QListView {
    QString clickedItemShortcut() const;
    int clickedItemIndex() const;
 
+   /**
+    * @brief Id of the clicked action, -1 for actions added without one.
+    */
+   int clickedItemId() const;
+
+   /**
+    * @brief Hash lookups by action id. Ids are expected to be unique within a menu.
+    */
+   QModelIndex actionIndex(int id) const;
+   void setActionEnabled(int id, bool enable);
+
+   /**
+    * @brief Reports the action as clicked without opening the menu.
+    */
+   void triggerAction(int id);
+
+   /**
+    * @brief Binds the shortcut of every action with an id in ShortcutRegistry, including
+    * submenus of the menu tree that aren't built yet. Key presses then trigger the action directly.
+    * For tree actions clickedItemIndex() is the row within their own submenu. Sequences already taken are skipped with a warning.
+    * @param scope If given, the shortcuts only fire while the scope's window is active.
+    */
+   void registerShortcuts(QWidget *scope = nullptr);
+
    void setParentMenu(Menu *parentMenu);
+
+   /**
+    * @brief In overlay mode the menu is hosted inside the anchor's window. Submenus inherit it.
+    */
+   void setAnchorWidget(QWidget *anchor);
    
    void setItemSize(QSize size);
    QSize itemSize();
@@ -101,10 +262,23 @@ class Menu : public QListView {
    int maxVisibleItems() const;
 
    Delegate* delegate() const;
+
+   /**
+    * @brief Hash lookup of the first action with this text.
+    */
    QModelIndex itemIndex(const QString &itemText);
 
+   /**
+    * @brief Type-ahead, hovers the next action starting with the typed text.
+    * Menus never take focus, so keys are picked up by an application event filter while the menu is open.
+    */
+   void keyboardSearch(const QString &search) override;
+
    signals:
    void itemClicked();
+   void actionsStreamFinished();
+   void closed();
+   void actionTriggered(int id);
 
    private slots:
    void onItemClicked(const QModelIndex &index);
@@ -112,15 +286,33 @@ class Menu : public QListView {
    protected:
    void mouseMoveEvent(QMouseEvent *event) override;
    void leaveEvent(QEvent *event) override;
-   bool eventFilter(QObject *o, QEvent *event) override;
+   bool eventFilter(QObject *obj, QEvent *event) override;
    
    private:
    void init();   
    void updateMenu();
+   MenuItem *createItem(const MenuAction &menuAction) const;
+   QStandardItem *createDividerItem(Delegate::RowKind kind, const QString &title);
+   void appendItems(const QList<QStandardItem*> &rows);
+   void mergeItems(const QList<QStandardItem*> &rows);
+   void shiftSubMenus(int from, int delta);
+   bool matchesAction(int row, const MenuAction &menuAction) const;
+   void closeActionStream();
    void setHoveredIndex(const QModelIndex &index);
+   void hoverNextRow(int step);
+   void showSubMenu(int row);
+   void prefetchVisibleRows();
+   void setMenuNodes(std::shared_ptr<const std::vector<MenuNode>> tree, const std::vector<MenuNode> &nodes);
+   void ensureSubMenu(const QModelIndex &index);
+   void releaseSubMenu(Menu *subMenu);
+   void releaseLazySubMenus();
+   void reportClick(const QString &text, const QString &shortcut, int row, int id, const MenuNode *node);
+   void indexActionRows(int first, int last);
+   static int actionId(const QStandardItem *item);
 
    QPoint adjustXY(const QSize &s, const QPoint &p, const QRect &screenGeo, bool isSubMenu);
    QPoint adjustSubMenuPosition(Menu *subMenu, const QPoint &intendedPos);
+   QWidget *effectiveAnchor() const;
 
    // Flags
    bool isIconic = false;
@@ -133,11 +325,20 @@ class Menu : public QListView {
    QString _clickedItemShortcut;
    QString _clickedItemText;
    int _clickedItemIndex = -1;
+   int _clickedItemId = -1;
+
+   // Rows of actions by id
+   QHash<int, QPersistentModelIndex> actionRows;
    
    // Submenus
    QMap<int, Menu*> subMenus;
    QTimer *subMenuTimer = nullptr;
-   QModelIndex hoveredIndex;
+   QPersistentModelIndex hoveredIndex;
+
+   // Menu tree, rows point at their node and submenus are built on first hover
+   std::shared_ptr<const std::vector<MenuNode>> menuTree;
+   QList<QPointer<Menu>> lazySubMenus;
+   bool releaseSubMenusOnClose = false;
 
    // Popup
    RoundedBox *popup = nullptr;
@@ -147,6 +348,20 @@ class Menu : public QListView {
 
    // Model
    QStandardItemModel _model;
+   QPointer<PagedModel> pagedModel;
+
+   // Sorting, keys are parallel to the rows of _model in sorted modes
+   ComboModel::SortMode _sortMode = ComboModel::InsertionOrder;
+   QCollator collator;
+   std::vector<QCollatorSortKey> actionKeys;
+
+   // Lookup by text
+   ItemIndex textIndex;
+   TypeAhead typeAhead;
+
+   // Actions streamed in from a worker thread
+   std::shared_ptr<ItemStream<MenuAction>> actionStream;
+   StreamDrainer *streamDrainer = nullptr;
 
    // Layout
    QVBoxLayout *layout = nullptr;
@@ -154,12 +369,14 @@ class Menu : public QListView {
    // Scroll Bar
    ScrollBar *vScroll = nullptr;
    
-   // Opacity Effect & Animation for Fade In & Out Effect
-   SmoothOpacity *smooth_opacity = nullptr;
-   QPropertyAnimation *animation = nullptr;
+   // Fade In & Out
+   Fader *fader = nullptr;
 
    // Parent Menu
    Menu *parentMenu = nullptr;
+
+   // Anchor for overlay placement
+   QPointer<QWidget> _anchorWidget;
    
    // Items Size
    QSize _itemSize;
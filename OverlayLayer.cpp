@@ -0,0 +1,109 @@
+#include "OverlayLayer.h"
+
+bool OverlayLayer::enabled = false;
+
+void OverlayLayer::setEnabled(bool enable) { enabled = enable; }
+bool OverlayLayer::isEnabled() { return enabled; }
+
+QHash<const QWidget*, OverlayLayer::Origin> &OverlayLayer::origins() {
+    static QHash<const QWidget*, Origin> table;
+    return table;
+}
+
+bool OverlayLayer::isHosted(const QWidget *popup) { return origins().contains(popup); }
+bool OverlayLayer::isEmbedded(const QWidget *popup) { return isHosted(popup) && !nativeWindow(popup); }
+
+PopupWindow *OverlayLayer::nativeWindow(const QWidget *popup) {
+    auto it = origins().constFind(popup);
+    return it != origins().constEnd() ? it->window.data() : nullptr;
+}
+
+OverlayLayer::Origin &OverlayLayer::record(QWidget *popup) {
+    // Remember where the popup came from, so release() can hand it back
+    if (!isHosted(popup)) {
+        QMetaObject::Connection guard = QObject::connect(popup, &QObject::destroyed, [popup]() { 
+            Origin origin = origins().take(popup);
+            PopupWindowPool::release(origin.window);
+        });
+
+        // While hosted the popup is not a child of its owner, but must still die with it
+        QMetaObject::Connection ownerGuard;
+        if (QWidget *owner = popup->parentWidget()) 
+            ownerGuard = QObject::connect(owner, &QObject::destroyed, popup, [popup]() { popup->deleteLater(); });
+
+        origins().insert(popup, { popup->parentWidget(), popup->windowFlags(), guard, ownerGuard, nullptr });
+    }
+
+    return origins()[popup];
+}
+
+void OverlayLayer::embed(QWidget *popup, QWidget *host) {
+    if (popup->parentWidget() == host && !popup->isWindow()) 
+        return;
+
+    Origin &origin = record(popup);
+    PopupWindow *window = origin.window;
+    origin.window = nullptr;
+
+    const bool wasVisible = popup->isVisible();
+    popup->setParent(host, Qt::Widget);
+
+    // No longer needs its native window
+    PopupWindowPool::release(window);
+
+    if (wasVisible) 
+        popup->show();
+}
+
+void OverlayLayer::place(QWidget *popup, QWidget *anchor, const QPoint &globalPos, PopupWindow::Kind kind) {
+    if (!popup) 
+        return;
+
+    QWidget *host = anchor ? anchor->window() : nullptr;
+
+    if (enabled && host && host != popup && !qobject_cast<PopupWindow *>(host)) {
+        QRect localRect(host->mapFromGlobal(globalPos), popup->size());
+
+        if (host->rect().contains(localRect)) {
+            embed(popup, host);
+            popup->move(localRect.topLeft());
+            popup->raise();
+            return;
+        }
+    }
+
+    // Extends past the host window (or overlay mode is off), use a pooled native window
+    PopupWindow *window = nativeWindow(popup);
+
+    if (!window) {
+        const bool wasVisible = popup->isVisible();
+
+        window = PopupWindowPool::acquire(kind);
+        record(popup).window = window;
+        window->host(popup);
+
+        if (wasVisible) 
+            popup->show();
+    }
+
+    window->move(globalPos);
+}
+
+void OverlayLayer::ensureHosted(QWidget *popup, QWidget *anchor, PopupWindow::Kind kind) {
+    if (!popup || isHosted(popup)) 
+        return;
+
+    place(popup, anchor, popup->isWindow() ? popup->pos() : popup->mapToGlobal(QPoint(0, 0)), kind);
+}
+
+void OverlayLayer::release(QWidget *popup) {
+    if (!popup || !isHosted(popup)) 
+        return;
+
+    Origin origin = origins().take(popup);
+    QObject::disconnect(origin.guard);
+    QObject::disconnect(origin.ownerGuard);
+
+    popup->setParent(origin.parent, origin.flags);
+    PopupWindowPool::release(origin.window);
+}
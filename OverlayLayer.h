@@ -0,0 +1,58 @@
+#pragma once
+
+#include "PopupWindowPool.h"
+
+#include <QWidget>
+#include <QPointer>
+#include <QHash>
+#include <QPoint>
+#include <QRect>
+
+/**
+ * @brief Hosts open popups, menus and tooltips.
+ * In overlay mode an open popup becomes a child of its anchor's top-level window when it fits
+ * inside it. Otherwise (or with overlay mode off) it is hosted in a pooled native PopupWindow.
+ * Closed popups are handed back to their original parent.
+ */
+class OverlayLayer {
+    public:
+    /**
+     * @brief Library-wide switch, disabled by default.
+     */
+    static void setEnabled(bool enable);
+    static bool isEnabled();
+
+    /**
+     * @brief Moves the popup to globalPos, hosting it inside the anchor's window when it fits.
+     */
+    static void place(QWidget *popup, QWidget *anchor, const QPoint &globalPos, PopupWindow::Kind kind = PopupWindow::PopupKind);
+
+    /**
+     * @brief Hosts the popup at its current position if it is not hosted yet. Call before showing.
+     */
+    static void ensureHosted(QWidget *popup, QWidget *anchor, PopupWindow::Kind kind = PopupWindow::PopupKind);
+
+    /**
+     * @brief Hands a closed popup back to its original parent, returning its native window to the pool.
+     */
+    static void release(QWidget *popup);
+
+    static bool isHosted(const QWidget *popup);
+    static bool isEmbedded(const QWidget *popup);
+    static PopupWindow *nativeWindow(const QWidget *popup);
+
+    private:
+    struct Origin {
+        QPointer<QWidget> parent;
+        Qt::WindowFlags flags;
+        QMetaObject::Connection guard;
+        QMetaObject::Connection ownerGuard;
+        QPointer<PopupWindow> window;
+    };
+
+    static Origin &record(QWidget *popup);
+    static void embed(QWidget *popup, QWidget *host);
+    static QHash<const QWidget*, Origin> &origins();
+
+    static bool enabled;
+};
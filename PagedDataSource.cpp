@@ -0,0 +1,20 @@
+#include "PagedDataSource.h"
+
+StaticPagedDataSource::StaticPagedDataSource(int rows, int latencyMs, bool reportsRowCount, const QString &prefix) 
+    : _rows(std::max(rows, 0)), _latencyMs(latencyMs), _reportsRowCount(reportsRowCount), _prefix(prefix) {}
+
+int StaticPagedDataSource::rowCount() const { return _reportsRowCount ? _rows : -1; }
+
+QVector<PagedDataSource::Row> StaticPagedDataSource::fetch(int first, int count) const {
+    if (_latencyMs > 0) 
+        QThread::msleep(_latencyMs);
+
+    QVector<Row> rows;
+    const int last = std::min(first + count, _rows);
+    rows.reserve(std::max(last - first, 0));
+
+    for (int row = first; row < last; ++row) 
+        rows.append({ QString("%1 %2").arg(_prefix).arg(row + 1) });
+
+    return rows;
+}
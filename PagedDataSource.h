@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QThread>
+
+#include "ComboModel.h"
+
+class PagedDataSource {
+    public:
+    using Row = ComboModel::Item;
+
+    virtual ~PagedDataSource() = default;
+
+    /**
+     * @brief Total number of rows, or -1 if unknown. Unknown sources are read page by page
+     * until fetch() returns fewer rows than asked for. Called on the GUI thread, keep it cheap.
+     */
+    virtual int rowCount() const = 0;
+
+    /**
+     * @brief Called on worker threads, possibly for several pages at once.
+     * @warning Must be thread-safe and must not touch any widget.
+     */
+    virtual QVector<Row> fetch(int first, int count) const = 0;
+};
+
+/**
+ * @brief Generates "<prefix> N" rows on demand, with optional artificial latency per page.
+ * Handy as a stand-in for a database-backed source while testing.
+ */
+class StaticPagedDataSource : public PagedDataSource {
+    public:
+    explicit StaticPagedDataSource(int rows, int latencyMs = 0, bool reportsRowCount = true, const QString &prefix = "Item");
+
+    int rowCount() const override;
+    QVector<Row> fetch(int first, int count) const override;
+
+    private:
+    const int _rows;
+    const int _latencyMs;
+    const bool _reportsRowCount;
+    const QString _prefix;
+};
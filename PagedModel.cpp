@@ -0,0 +1,202 @@
+#include "PagedModel.h"
+
+PagedModel::PagedModel(QObject *parent) : QAbstractListModel(parent) {}
+
+PagedModel::~PagedModel() { cancelRequests(); }
+
+void PagedModel::setSource(std::shared_ptr<PagedDataSource> source) {
+    beginResetModel();
+
+    cancelRequests();
+    pages.clear();
+    recentPages.clear();
+
+    _source = std::move(source);
+    exposedRows = 0;
+    totalRows = _source ? _source->rowCount() : 0;
+    reachedEnd = !_source || totalRows == 0;
+
+    endResetModel();
+}
+
+std::shared_ptr<PagedDataSource> PagedModel::source() const { return _source; }
+
+void PagedModel::setPageSize(int rows) { 
+    // Changing the page size re-slices everything, start over
+    _pageSize = std::max(rows, 1); 
+    setSource(_source);
+}
+
+int PagedModel::pageSize() const { return _pageSize; }
+void PagedModel::setPrefetchRows(int rows) { _prefetchRows = rows; }
+void PagedModel::setMaxCachedPages(int pages) { _maxCachedPages = std::max(pages, 1); }
+
+void PagedModel::setDarkMode(bool value) { isDarkMode = value; }
+
+int PagedModel::rowCount(const QModelIndex &parent) const { return parent.isValid() ? 0 : exposedRows; }
+
+QVariant PagedModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= exposedRows) 
+        return QVariant();
+
+    auto it = pages.constFind(index.row() / _pageSize);
+    const int offset = index.row() % _pageSize;
+
+    if (it == pages.constEnd() || offset >= it->size()) 
+        return role == PlaceholderRole ? QVariant(true) : QVariant();
+
+    const PagedDataSource::Row &row = it->at(offset);
+
+    switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            return row.text;
+
+        case Qt::DecorationRole:
+            if (row.lightIcon.isEmpty() || row.darkIcon.isEmpty()) 
+                return QVariant();
+            return QIcon(isDarkMode ? row.darkIcon : row.lightIcon);
+
+        case LightIconRole:
+            return row.lightIcon;
+
+        case DarkIconRole:
+            return row.darkIcon;
+
+        case PlaceholderRole:
+            return false;
+
+        default:
+            return QVariant();
+    }
+}
+
+Qt::ItemFlags PagedModel::flags(const QModelIndex &index) const {
+    // Placeholders can't be picked until their page arrives
+    return isRowLoaded(index.row()) ? QAbstractListModel::flags(index) : Qt::NoItemFlags;
+}
+
+bool PagedModel::canFetchMore(const QModelIndex &parent) const {
+    if (parent.isValid() || !_source) 
+        return false;
+
+    return totalRows >= 0 ? exposedRows < totalRows : !reachedEnd;
+}
+
+void PagedModel::fetchMore(const QModelIndex &parent) {
+    if (!canFetchMore(parent)) 
+        return;
+
+    // New rows show up as placeholders right away and fill in once loaded
+    const int added = totalRows >= 0 ? std::min(_pageSize, totalRows - exposedRows) : _pageSize;
+    const int first = exposedRows;
+
+    beginInsertRows(QModelIndex(), first, first + added - 1);
+    exposedRows += added;
+    endInsertRows();
+
+    requestPage(first / _pageSize);
+}
+
+void PagedModel::prefetch(int firstRow, int lastRow) {
+    if (!_source || exposedRows == 0 || firstRow < 0) 
+        return;
+
+    const int margin = _prefetchRows >= 0 ? _prefetchRows : _pageSize;
+    const int firstPage = std::max(firstRow - margin, 0) / _pageSize;
+    const int lastPage = std::min(lastRow + margin, exposedRows - 1) / _pageSize;
+
+    for (int page = firstPage; page <= lastPage; ++page) {
+        if (pages.contains(page)) 
+            touch(page);
+        else 
+            requestPage(page);
+    }
+
+    // Scrolled up to the end of what is exposed, so expose the next page too
+    if (lastRow + margin >= exposedRows && canFetchMore(QModelIndex())) 
+        fetchMore(QModelIndex());
+}
+
+void PagedModel::requestPage(int page) {
+    if (!_source || pages.contains(page) || loading.contains(page)) 
+        return;
+
+    auto *watcher = new QFutureWatcher<QVector<PagedDataSource::Row>>(this);
+    loading.insert(page, watcher);
+
+    connect(watcher, &QFutureWatcher<QVector<PagedDataSource::Row>>::finished, this, [this, watcher, page]() {
+        loading.remove(page);
+        watcher->deleteLater();
+        onPageFetched(page, watcher->result());
+    });
+
+    std::shared_ptr<PagedDataSource> source = _source;
+    const int first = page * _pageSize;
+    const int count = _pageSize;
+
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [source, first, count]() {
+        return source->fetch(first, count);
+    }));
+}
+
+void PagedModel::onPageFetched(int page, const QVector<PagedDataSource::Row> &rows) {
+    const int first = page * _pageSize;
+
+    // A short page from a source of unknown size marks its end
+    if (totalRows < 0 && rows.size() < _pageSize) {
+        reachedEnd = true;
+        totalRows = first + int(rows.size());
+
+        if (exposedRows > totalRows) {
+            beginRemoveRows(QModelIndex(), totalRows, exposedRows - 1);
+            exposedRows = totalRows;
+            endRemoveRows();
+        }
+    }
+
+    pages.insert(page, rows);
+    touch(page);
+    evictPages();
+
+    const int last = std::min(first + int(rows.size()), exposedRows) - 1;
+    if (first <= last) 
+        emit dataChanged(index(first), index(last));
+
+    emit pageLoaded(page);
+}
+
+void PagedModel::touch(int page) {
+    recentPages.removeOne(page);
+    recentPages.append(page);
+}
+
+void PagedModel::evictPages() {
+    // Least recently viewed pages go back to being placeholders
+    while (pages.size() > _maxCachedPages && !recentPages.isEmpty()) {
+        const int page = recentPages.takeFirst();
+        pages.remove(page);
+
+        const int first = page * _pageSize;
+        const int last = std::min(first + _pageSize, exposedRows) - 1;
+        if (first <= last) 
+            emit dataChanged(index(first), index(last));
+    }
+}
+
+void PagedModel::cancelRequests() {
+    // Results of a replaced source must never reach the model
+    for (auto *watcher : std::as_const(loading)) {
+        disconnect(watcher, nullptr, this, nullptr);
+        watcher->cancel();
+        watcher->deleteLater();
+    }
+    loading.clear();
+}
+
+bool PagedModel::isRowLoaded(int row) const {
+    auto it = pages.constFind(row / _pageSize);
+    return row >= 0 && it != pages.constEnd() && row % _pageSize < it->size();
+}
+
+int PagedModel::loadingPageCount() const { return int(loading.size()); }
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QModelIndex>
+#include <QVariant>
+#include <QHash>
+#include <QList>
+#include <QIcon>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include <memory>
+#include <utility>
+
+#include "PagedDataSource.h"
+
+/**
+ * @brief List model over a PagedDataSource. Rows are exposed page by page through
+ * canFetchMore()/fetchMore() and loaded on the global thread pool. Rows whose page is not
+ * loaded yet report PlaceholderRole and paint as a placeholder.
+ * Only a bounded number of pages is kept, pages far from the viewport are dropped and reloaded on demand.
+ */
+class PagedModel : public QAbstractListModel {
+    Q_OBJECT
+
+    public:
+    enum Roles { LightIconRole = Qt::UserRole + 3, DarkIconRole = Qt::UserRole + 4, PlaceholderRole = Qt::UserRole + 5 };
+
+    explicit PagedModel(QObject *parent = nullptr);
+    ~PagedModel() override;
+
+    void setSource(std::shared_ptr<PagedDataSource> source);
+    std::shared_ptr<PagedDataSource> source() const;
+
+    void setPageSize(int rows);
+    int pageSize() const;
+
+    /**
+     * @brief Rows around the viewport that are loaded ahead of time. Defaults to one page.
+     */
+    void setPrefetchRows(int rows);
+
+    /**
+     * @brief Upper bound of pages held in memory. Default is 64.
+     */
+    void setMaxCachedPages(int pages);
+
+    /**
+     * @brief Makes sure the pages for [firstRow - prefetch, lastRow + prefetch] are loaded or in flight.
+     * Views call this whenever their visible rows change.
+     */
+    void prefetch(int firstRow, int lastRow);
+
+    void setDarkMode(bool value);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    bool isRowLoaded(int row) const;
+    int loadingPageCount() const;
+
+    signals:
+    void pageLoaded(int page);
+
+    private:
+    void requestPage(int page);
+    void onPageFetched(int page, const QVector<PagedDataSource::Row> &rows);
+    void touch(int page);
+    void evictPages();
+    void cancelRequests();
+
+    std::shared_ptr<PagedDataSource> _source;
+    int _pageSize = 256;
+    int _prefetchRows = -1;
+    int _maxCachedPages = 64;
+
+    // Rows announced to views so far, and the known total (-1 until the end is reached)
+    int exposedRows = 0;
+    int totalRows = -1;
+    bool reachedEnd = false;
+
+    QHash<int, QVector<PagedDataSource::Row>> pages;
+    QHash<int, QFutureWatcher<QVector<PagedDataSource::Row>>*> loading;
+    QList<int> recentPages;
+
+    bool isDarkMode = false;
+};
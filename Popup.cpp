@@ -1,8 +1,8 @@
 #include "Popup.h"
 
-Popup::Popup(QWidget *parent) : RoundedBox(parent) {
+Popup::Popup(QWidget *parent) : RoundedBox(parent), anchorWidget(parent) {
     // Items List
-    _list = new QListView(this);
+    _list = new VariableRowView(this);
 
     // Scrollbar
     vScroll = new ScrollBar(Qt::Vertical);
@@ -30,14 +30,20 @@ Popup::Popup(QWidget *parent) : RoundedBox(parent) {
     layout->addSpacing(0);
     layout->addWidget(_list, 0, Qt::AlignVCenter);
 
-    // Opacity Effect
-    smooth_opacity = new SmoothOpacity(this);
-    setGraphicsEffect(smooth_opacity);
-
-    // Opacity Effect Animation
-    animation = new QPropertyAnimation(smooth_opacity, "opacity", this);
-    animation->setEasingCurve(QEasingCurve::InOutQuad);
-    animation->setDuration(300);
+    // Icons only for rows in and near the viewport
+    connect(vScroll, &QScrollBar::valueChanged, this, &Popup::prefetchVisibleRows);
+    connect(IconLoader::instance(), &IconLoader::iconReady, this, [this]() {
+        if (isVisible()) 
+            _list->viewport()->update();
+    });
+
+    // Fade In & Out
+    fader = new Fader(this);
+    connect(fader, &Fader::fadedIn, this, &Popup::opened);
+    connect(fader, &Fader::fadedOut, this, [this]() { 
+        hide(); 
+        OverlayLayer::release(this);
+    });
 
     hide();
 }
@@ -58,11 +64,15 @@ void Popup::updatePopup() {
 
     int height = (visibleItems * itemsHeight) + (_list->spacing()) * (visibleItems - 1) + 8;
 
+    // Variable heights, the first visible rows decide
+    if (_list->hasVariableRowHeights()) 
+        height = _list->rowTop(visibleItems) - _list->spacing() + 8;
+
     _list->setVerticalScrollBarPolicy(totalItems > visibleItems ? Qt::ScrollBarAsNeeded : Qt::ScrollBarAlwaysOff);
     _list->setFixedHeight(height);
     
     int widthToUse = (explicitWidth > 0) ? explicitWidth 
-                                        : (parentWidget() ? parentWidget()->width() : 150);
+                                        : (anchorWidget ? anchorWidget->width() : 150);
 
     setFixedSize(widthToUse, height);
 }
@@ -72,7 +82,12 @@ void Popup::setSelectionMode(QAbstractItemView::SelectionMode mode) {
 }
 
 void Popup::setModel(QAbstractItemModel *model) {
-    if (_list) _list->setModel(model);
+    if (!_list) return;
+    _list->setModel(model);
+
+    // Paged models start empty, expose their first page so the popup has a size
+    if (model && model->rowCount() == 0 && model->canFetchMore(QModelIndex())) 
+        model->fetchMore(QModelIndex());
 }
 
 void Popup::setItemDelegate(QAbstractItemDelegate *delegate) {
@@ -80,31 +95,123 @@ void Popup::setItemDelegate(QAbstractItemDelegate *delegate) {
 }
 
 void Popup::fadeIn() {
-    if (!animation) return;
-
-    animation->stop();
-    disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-    animation->setStartValue(0.0);
-    animation->setEndValue(1.0);
-    show();
-    animation->start();
+    if (!fader) return;
+
+    OverlayLayer::ensureHosted(this, anchorWidget);
+    prefetchVisibleRows();
+
+    if (isInstantOpen) {
+        fader->stop();
+        show();
+        emit opened();
+    } else {
+        fader->fadeIn();
+        show();
+    }
+
+    PopupManager::instance()->push(this, anchorWidget, [this]() { fadeOut(); });
 }
 
 void Popup::fadeOut() {
-    if (!animation) return;
-
-    animation->stop();
-    disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-    animation->setStartValue(1.0);
-    animation->setEndValue(0.0);
-    connect(animation, &QPropertyAnimation::finished, this, [this]() { hide(); });
-    animation->start();
+    if (!fader) return;
+
+    PopupManager::instance()->remove(this);
+    fader->fadeOut();
 }
 
 void Popup::setMaxVisibleItems(int items) {
     maxVisibleItems = items;
 }
 
+void Popup::setAnchorWidget(QWidget *anchor) { anchorWidget = anchor; }
+void Popup::setInstantOpen(bool value) { isInstantOpen = value; }
+
+std::pair<int, int> Popup::visibleRows(int margin) const {
+    const QAbstractItemModel *model = _list->model();
+    const int rowCount = model ? model->rowCount() : 0;
+    if (rowCount <= 0) 
+        return { -1, -1 };
+
+    const QRect area = _list->viewport()->rect();
+    int first = _list->indexAt(area.topLeft()).row();
+    int last = _list->indexAt(QPoint(area.left(), area.bottom())).row();
+
+    // Viewport not laid out yet or partially empty
+    if (first < 0) 
+        first = 0;
+    if (last < 0) 
+        last = std::min(rowCount, first + maxVisibleItems) - 1;
+
+    return { std::max(first - margin, 0), std::min(last + margin, rowCount - 1) };
+}
+
+void Popup::prefetchVisibleRows() {
+    prefetchSourcePages();
+
+    auto *delegate = qobject_cast<Delegate*>(_list->itemDelegate());
+    if (!delegate) 
+        return;
+
+    const auto [first, last] = visibleRows(maxVisibleItems);
+    if (first >= 0) 
+        delegate->prewarm(_list->model(), first, last - first + 1);
+}
+
+void Popup::prefetchSourcePages() {
+    // ComboBox shows its rows through a filter proxy, so look for the PagedModel underneath
+    QAbstractItemModel *model = _list->model();
+    QList<QAbstractProxyModel*> proxies;
+
+    while (auto *proxy = qobject_cast<QAbstractProxyModel*>(model)) {
+        proxies.append(proxy);
+        model = proxy->sourceModel();
+    }
+
+    auto *paged = qobject_cast<PagedModel*>(model);
+    const auto [first, last] = visibleRows();
+    if (!paged || first < 0) 
+        return;
+
+    if (proxies.isEmpty()) {
+        paged->prefetch(first, last);
+        return;
+    }
+
+    std::vector<int> sourceRows;
+    sourceRows.reserve(last - first + 1);
+
+    for (int row = first; row <= last; ++row) {
+        QModelIndex index = _list->model()->index(row, 0);
+        for (const QAbstractProxyModel *proxy : std::as_const(proxies)) 
+            index = proxy->mapToSource(index);
+
+        if (index.isValid()) 
+            sourceRows.push_back(index.row());
+    }
+
+    if (sourceRows.empty()) 
+        return;
+
+    // A filtered list can show rows far apart, each cluster gets its own window
+    // instead of one range that would load every page in between
+    std::sort(sourceRows.begin(), sourceRows.end());
+
+    int runStart = sourceRows.front();
+    int runEnd = runStart;
+
+    for (int row : sourceRows) {
+        if (row - runEnd > paged->pageSize()) {
+            paged->prefetch(runStart, runEnd);
+            runStart = row;
+        }
+        runEnd = row;
+    }
+
+    paged->prefetch(runStart, runEnd);
+}
+
+void Popup::placeAt(const QPoint &globalPos) { OverlayLayer::place(this, anchorWidget, globalPos); }
+
 void Popup::setDarkMode(bool value) {
     if (vScroll) 
         vScroll->setDarkMode(value);
@@ -112,6 +219,11 @@ void Popup::setDarkMode(bool value) {
     RoundedBox::setDarkMode(value);
 }
 
+void Popup::setVariableRowHeights(bool enable) {
+    _list->setVariableRowHeights(enable);
+    updatePopup();
+}
+
 QListView* Popup::list() const {
     return _list;
 }
@@ -1,12 +1,21 @@
 #pragma once
 #include <QListView>
 #include <QVBoxLayout>
-#include <QPropertyAnimation>
 #include <QAbstractItemModel>
+#include <QAbstractProxyModel>
 #include <QAbstractItemDelegate>
 #include "RoundedBox.h"
 #include "ScrollBar.h"
-#include "SmoothOpacity.h"
+#include "Fader.h"
+#include "PopupManager.h"
+#include "OverlayLayer.h"
+#include "Delegate.h"
+#include "IconLoader.h"
+#include "PagedModel.h"
+#include "VariableRowView.h"
+#include <utility>
+#include <vector>
+#include <algorithm>
 
 class Popup : public RoundedBox {
     Q_OBJECT
@@ -24,18 +33,57 @@ class Popup : public RoundedBox {
     void setMaxVisibleItems(int items);
     void setDarkMode(bool value);
 
+    /**
+     * @brief Rows take their own height from the delegate (headers, separators, two-line items).
+     */
+    void setVariableRowHeights(bool enable);
+
+    /**
+     * @brief Clicks on the anchor don't dismiss the popup. Defaults to the parent widget.
+     */
+    void setAnchorWidget(QWidget *anchor);
+
+    /**
+     * @brief Moves the popup to a global position, inside the anchor's window in overlay mode.
+     */
+    void placeAt(const QPoint &globalPos);
+
+    /**
+     * @brief Shows the popup right away on fadeIn(), without the fade-in animation.
+     */
+    void setInstantOpen(bool value);
+
+    /**
+     * @brief First and last row inside the viewport, widened by margin rows on both sides.
+     * Returns {-1, -1} for an empty list.
+     */
+    std::pair<int, int> visibleRows(int margin = 0) const;
+
+    /**
+     * @brief Asks the Delegate to prepare icons for the visible rows plus one page around them.
+     * A PagedModel, shown directly or behind proxy models, additionally loads the pages of its prefetch window.
+     */
+    void prefetchVisibleRows();
+
     QListView* list() const;
 
+    signals:
+    void opened();
+
     private:    
+    void prefetchSourcePages();
+
     int maxVisibleItems = 8;
     int explicitWidth = 0;
+    bool isInstantOpen = false;
+
+    QWidget *anchorWidget = nullptr;
 
     ScrollBar *vScroll = nullptr;
 
-    QListView *_list = nullptr;
+    VariableRowView *_list = nullptr;
 
-    SmoothOpacity *smooth_opacity = nullptr;
-    QPropertyAnimation *animation = nullptr;
+    Fader *fader = nullptr;
     
     QVBoxLayout *layout = nullptr;
 };
@@ -0,0 +1,110 @@
+#include "PopupManager.h"
+
+PopupManager::PopupManager(QObject *parent) : QObject(parent) {}
+
+PopupManager *PopupManager::instance() {
+    static PopupManager *manager = new PopupManager(qApp);
+    return manager;
+}
+
+void PopupManager::push(QWidget *popup, QWidget *anchor, const std::function<void()> &dismiss) {
+    if (!popup) 
+        return;
+
+    remove(popup);
+    stack.append({ popup, anchor, dismiss });
+    updateFilter();
+}
+
+void PopupManager::remove(QWidget *popup) {
+    for (int i = stack.size() - 1; i >= 0; --i) 
+        if (stack[i].popup == popup) 
+            stack.removeAt(i);
+
+    prune();
+    updateFilter();
+}
+
+bool PopupManager::contains(QWidget *popup) const {
+    for (const Entry &entry : stack) 
+        if (entry.popup == popup) 
+            return true;
+
+    return false;
+}
+
+void PopupManager::prune() {
+    // Popups destroyed or hidden behind our back
+    for (int i = stack.size() - 1; i >= 0; --i) 
+        if (!stack[i].popup || !stack[i].popup->isVisible()) 
+            stack.removeAt(i);
+}
+
+void PopupManager::updateFilter() {
+    const bool needed = !stack.isEmpty();
+
+    if (needed == isFiltering) 
+        return;
+
+    isFiltering = needed;
+    isFiltering ? qApp->installEventFilter(this) : qApp->removeEventFilter(this);
+}
+
+void PopupManager::dismissAll() {
+    // Dismiss callbacks call remove(), so work on a copy
+    const QVector<Entry> entries = stack;
+    stack.clear();
+    updateFilter();
+
+    for (int i = entries.size() - 1; i >= 0; --i) 
+        if (entries[i].popup && entries[i].dismiss) 
+            entries[i].dismiss();
+}
+
+void PopupManager::dismissOutside(QWidget *clickedWidget) {
+    prune();
+
+    QVector<Entry> dismissed;
+
+    // Walk from the topmost popup down until one contains the click
+    while (!stack.isEmpty()) {
+        const Entry &top = stack.last();
+
+        bool insidePopup = clickedWidget && (top.popup == clickedWidget || top.popup->isAncestorOf(clickedWidget));
+        bool insideAnchor = clickedWidget && top.anchor && (top.anchor == clickedWidget || top.anchor->isAncestorOf(clickedWidget));
+
+        if (insidePopup || insideAnchor) 
+            break;
+
+        dismissed.append(stack.takeLast());
+    }
+
+    updateFilter();
+
+    for (const Entry &entry : dismissed) 
+        if (entry.popup && entry.dismiss) 
+            entry.dismiss();
+}
+
+bool PopupManager::eventFilter(QObject *obj, QEvent *event) {
+    switch (event->type()) {
+        case QEvent::MouseButtonPress: {
+            // A native press reaches its QWindow exactly once, before being
+            // dispatched (and possibly propagated) through widgets
+            if (!obj->isWindowType()) 
+                break;
+
+            QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+            dismissOutside(QApplication::widgetAt(mouseEvent->globalPosition().toPoint()));
+            break;
+        }
+
+        case QEvent::ApplicationDeactivate: 
+            dismissAll();
+            break;
+
+        default: break;
+    }
+
+    return QObject::eventFilter(obj, event);
+}
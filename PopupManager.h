@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QWidget>
+#include <QPointer>
+#include <QVector>
+#include <QApplication>
+#include <QMouseEvent>
+#include <QEvent>
+#include <functional>
+
+/**
+ * @brief Tracks the stack of currently open popups (Popup, Menu, ToolTip) and dismisses them
+ * on outside clicks and application deactivation. The application event filter is only
+ * installed while at least one popup is open, and each press costs a single hit-test.
+ */
+class PopupManager : public QObject {
+    Q_OBJECT
+
+    public:
+    static PopupManager *instance();
+
+    /**
+     * @brief Pushes an opened popup on top of the stack.
+     * @param anchor Clicks on the anchor (e.g. the ComboBox field) do not dismiss the popup.
+     * @param dismiss Called when the popup must close.
+     */
+    void push(QWidget *popup, QWidget *anchor, const std::function<void()> &dismiss);
+    void remove(QWidget *popup);
+    bool contains(QWidget *popup) const;
+    void dismissAll();
+
+    protected:
+    bool eventFilter(QObject *obj, QEvent *event) override;
+
+    private:
+    explicit PopupManager(QObject *parent = nullptr);
+
+    struct Entry {
+        QPointer<QWidget> popup;
+        QPointer<QWidget> anchor;
+        std::function<void()> dismiss;
+    };
+
+    void prune();
+    void updateFilter();
+    void dismissOutside(QWidget *clickedWidget);
+
+    QVector<Entry> stack;
+    bool isFiltering = false;
+};
@@ -0,0 +1,131 @@
+#include "PopupWindowPool.h"
+
+PopupWindow::PopupWindow(Kind kind) : QWidget(nullptr), _kind(kind) {
+    if (kind == ToolTipKind) {
+        setWindowFlags(Qt::FramelessWindowHint | Qt::NoDropShadowWindowHint | Qt::ToolTip);
+        setAttribute(Qt::WA_ShowWithoutActivating);
+        setFocusPolicy(Qt::NoFocus);
+    } else {
+        setWindowFlags(Qt::FramelessWindowHint | Qt::NoDropShadowWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool);
+    }
+
+    setAttribute(Qt::WA_TranslucentBackground);
+}
+
+void PopupWindow::host(QWidget *content) {
+    releaseContent();
+
+    if (!content) 
+        return;
+
+    _content = content;
+    content->setParent(this, Qt::Widget);
+    content->move(0, 0);
+    content->installEventFilter(this);
+    resize(content->size());
+}
+
+void PopupWindow::releaseContent() {
+    if (_content) 
+        _content->removeEventFilter(this);
+
+    _content = nullptr;
+}
+
+QWidget *PopupWindow::content() const { return _content; }
+PopupWindow::Kind PopupWindow::kind() const { return _kind; }
+
+bool PopupWindow::eventFilter(QObject *obj, QEvent *event) {
+    if (obj == _content) {
+        switch (event->type()) {
+            case QEvent::ShowToParent:
+                show();
+                raise();
+                break;
+
+            case QEvent::HideToParent:
+                hide();
+                break;
+
+            case QEvent::Resize:
+                resize(static_cast<QResizeEvent *>(event)->size());
+                break;
+
+            default: break;
+        }
+    }
+
+    return QWidget::eventFilter(obj, event);
+}
+
+int PopupWindowPool::maxIdle = 2;
+int PopupWindowPool::live = 0;
+
+QVector<QPointer<PopupWindow>> &PopupWindowPool::idle(PopupWindow::Kind kind) {
+    static QVector<QPointer<PopupWindow>> popupWindows, toolTipWindows;
+    return kind == PopupWindow::ToolTipKind ? toolTipWindows : popupWindows;
+}
+
+PopupWindow *PopupWindowPool::acquire(PopupWindow::Kind kind) {
+    QVector<QPointer<PopupWindow>> &windows = idle(kind);
+
+    while (!windows.isEmpty()) 
+        if (PopupWindow *window = windows.takeLast()) 
+            return window;
+
+    // Native surface itself is only created by Qt on first show
+    PopupWindow *window = new PopupWindow(kind);
+    QObject::connect(window, &QObject::destroyed, []() { --live; });
+    ++live;
+
+    return window;
+}
+
+void PopupWindowPool::release(PopupWindow *window) {
+    if (!window) 
+        return;
+
+    window->hide();
+    window->releaseContent();
+    window->setWindowOpacity(1.0);
+
+    QVector<QPointer<PopupWindow>> &windows = idle(window->kind());
+
+    if (windows.size() < maxIdle) 
+        windows.append(window);
+    else 
+        window->deleteLater();
+}
+
+void PopupWindowPool::prewarm(PopupWindow::Kind kind) {
+    QVector<QPointer<PopupWindow>> &windows = idle(kind);
+    windows.removeAll(nullptr);
+
+    if (!windows.isEmpty() || maxIdle == 0) 
+        return;
+
+    PopupWindow *window = new PopupWindow(kind);
+    QObject::connect(window, &QObject::destroyed, []() { --live; });
+    ++live;
+
+    window->create();
+    windows.append(window);
+}
+
+void PopupWindowPool::setMaxIdle(int count) {
+    maxIdle = std::max(count, 0);
+
+    for (PopupWindow::Kind kind : { PopupWindow::PopupKind, PopupWindow::ToolTipKind }) {
+        QVector<QPointer<PopupWindow>> &windows = idle(kind);
+
+        while (windows.size() > maxIdle) 
+            if (PopupWindow *window = windows.takeLast()) 
+                window->deleteLater();
+    }
+}
+
+int PopupWindowPool::liveCount() { return live; }
+
+int PopupWindowPool::idleCount() { 
+    return idle(PopupWindow::PopupKind).size() + idle(PopupWindow::ToolTipKind).size(); 
+}
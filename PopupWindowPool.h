@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QWidget>
+#include <QPointer>
+#include <QVector>
+#include <QEvent>
+#include <QResizeEvent>
+#include <algorithm>
+
+/**
+ * @brief Frameless translucent native window that hosts one open popup at a time.
+ * It mirrors the hosted widget's visibility and size.
+ */
+class PopupWindow : public QWidget {
+    Q_OBJECT
+
+    public:
+    enum Kind {
+        PopupKind,
+        ToolTipKind,
+    };
+
+    explicit PopupWindow(Kind kind);
+
+    void host(QWidget *content);
+    void releaseContent();
+
+    QWidget *content() const;
+    Kind kind() const;
+
+    protected:
+    bool eventFilter(QObject *obj, QEvent *event) override;
+
+    private:
+    Kind _kind;
+    QPointer<QWidget> _content;
+};
+
+/**
+ * @brief Hands out native popup windows at open time and takes them back on close.
+ * Windows are created on first demand (and their native surface on first show), so the native
+ * window count follows the number of popups open at once, not the number of widgets.
+ */
+class PopupWindowPool {
+    public:
+    static PopupWindow *acquire(PopupWindow::Kind kind);
+    static void release(PopupWindow *window);
+
+    /**
+     * @brief Creates an idle window with its native surface ahead of the first open.
+     */
+    static void prewarm(PopupWindow::Kind kind);
+
+    /**
+     * @brief Idle windows kept around per kind for reuse. Default is 2.
+     */
+    static void setMaxIdle(int count);
+
+    static int liveCount();
+    static int idleCount();
+
+    private:
+    static QVector<QPointer<PopupWindow>> &idle(PopupWindow::Kind kind);
+
+    static int maxIdle;
+    static int live;
+};
@@ -1,8 +1,8 @@
 #include "RoundedBox.h"
 
 RoundedBox::RoundedBox(bool isToolTip, QWidget *parent) : QWidget(nullptr), isDarkMode(false), _isToolTip(isToolTip) {
+    // Native window (if any) comes from PopupWindowPool when the box is opened
     if (isToolTip) {
-        setWindowFlags( Qt::FramelessWindowHint | Qt::NoDropShadowWindowHint | Qt::ToolTip);
         setAttribute(Qt::WA_ShowWithoutActivating);
         setFocusPolicy(Qt::NoFocus);
         setAttribute(Qt::WA_TranslucentBackground);
@@ -10,7 +10,6 @@ RoundedBox::RoundedBox(bool isToolTip, QWidget *parent) : QWidget(nullptr), isDa
 }
 
 RoundedBox::RoundedBox(QWidget *parent) : QWidget(parent) {
-    setWindowFlags(Qt::FramelessWindowHint | Qt::NoDropShadowWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool);
     setAttribute(Qt::WA_TranslucentBackground);
 }
 
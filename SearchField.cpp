@@ -0,0 +1,187 @@
+#include "SearchField.h"
+
+SearchField::SearchField(QWidget *parent) : TextField(parent) {
+    setFixedSize(QSize(250, 36));
+    init();
+}
+
+void SearchField::init() {
+    // Search Icon
+    setIconic(true);
+    setIconPaths(SearchIcon, SearchIcon);
+    setClearButton(true);
+
+    // Item Delegate
+    delegate = new Delegate(this->size());
+
+    // Popup
+    popup = new Popup(this);
+    popup->setModel(&model);
+    popup->setItemDelegate(delegate);
+    popup->setSelectionMode(QAbstractItemView::SingleSelection);
+    popup->setPopupWidth(this->width());
+
+    // Typing cancels whatever is in flight, the settled text starts a new query
+    connect(this, &QLineEdit::textChanged, this, &SearchField::cancelQuery);
+    connect(this, &TextField::textChangedDebounced, this, &SearchField::onQueryTextChanged);
+
+    // Any edit by the user makes the text a query again, even if it spells the activated suggestion
+    connect(this, &QLineEdit::textEdited, this, [this]() { activatedText.clear(); });
+
+    // List item Signal Slot
+    connect(popup->list(), &QListView::clicked, this, &SearchField::onSuggestionClicked);
+}
+
+void SearchField::setSuggestionProvider(std::shared_ptr<SuggestionProvider> provider) {
+    cancelQuery();
+    this->provider = std::move(provider);
+}
+
+void SearchField::setDarkMode(bool value) {
+    isDarkMode = value;
+    TextField::setDarkMode(value);
+    popup->setDarkMode(value);
+    delegate->setDarkMode(value);
+}
+
+void SearchField::setMaxVisibleItems(int items) { popup->setMaxVisibleItems(items); }
+void SearchField::setMinimumQueryLength(int length) { minimumQueryLength = std::max(length, 1); }
+
+QStringList SearchField::suggestions() const {
+    QStringList list;
+    list.reserve(model.rowCount());
+
+    for (int row = 0; row < model.rowCount(); ++row)
+        list.append(model.item(row)->text());
+
+    return list;
+}
+
+bool SearchField::isQueryRunning() const { return watcher && watcher->isRunning(); }
+
+void SearchField::cancelQuery() {
+    if (!watcher) 
+        return;
+
+    // Results of a cancelled query must never reach the popup
+    disconnect(watcher, nullptr, this, nullptr);
+    watcher->cancel();
+    watcher->deleteLater();
+    watcher = nullptr;
+}
+
+void SearchField::onQueryTextChanged(const QString &text) {
+    cancelQuery();
+    model.clear();
+
+    // Text was just filled in from an activated suggestion
+    if (text == activatedText) 
+        return;
+
+    if (!provider || text.trimmed().size() < minimumQueryLength) {
+        popup->fadeOut();
+        return;
+    }
+
+    watcher = new QFutureWatcher<QStringList>(this);
+    connect(watcher, &QFutureWatcher<QStringList>::resultsReadyAt, this, &SearchField::appendSuggestions);
+    connect(watcher, &QFutureWatcher<QStringList>::finished, this, &SearchField::finishQuery);
+
+    std::shared_ptr<SuggestionProvider> p = provider;
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [p, text](QPromise<QStringList> &promise) {
+        p->query(text, promise);
+    }));
+}
+
+void SearchField::appendSuggestions(int begin, int end) {
+    for (int i = begin; i < end; ++i) 
+        for (const QString &suggestion : watcher->resultAt(i)) 
+            model.appendRow(new QStandardItem(suggestion));
+
+    popup->updatePopup();
+
+    if (!popup->isVisible() && model.rowCount() > 0) 
+        positionPopup();
+}
+
+void SearchField::finishQuery() {
+    if (model.rowCount() == 0 && popup->isVisible()) 
+        popup->fadeOut();
+
+    emit suggestionsFinished();
+}
+
+void SearchField::onSuggestionClicked(const QModelIndex &index) {
+    if (!index.isValid()) 
+        return;
+
+    const QString suggestion = index.data(Qt::DisplayRole).toString();
+
+    // Setting the text must not trigger another query
+    activatedText = suggestion;
+    setText(suggestion);
+
+    cancelQuery();
+    popup->fadeOut();
+    emit suggestionActivated(suggestion);
+}
+
+void SearchField::positionPopup() {
+    QPoint globalPos = this->mapToGlobal(QPoint(0, 0));
+    QScreen *screen = QApplication::screenAt(globalPos);
+    if (!screen) 
+        screen = QApplication::primaryScreen();
+
+    QRect screenGeometry = screen->availableGeometry();
+    QRect fieldRect = QRect(globalPos, this->size());
+    QSize popupSize = popup->size();
+
+    QPoint belowPos(fieldRect.left(), fieldRect.bottom() + 4);
+    QPoint abovePos(fieldRect.left(), fieldRect.top() - popupSize.height() - 4);
+    QPoint currPosition = screenGeometry.contains(QRect(belowPos, popupSize)) ? belowPos : abovePos;
+
+    int x = std::clamp(currPosition.x(), screenGeometry.left(), screenGeometry.right() - popupSize.width());
+    int y = std::clamp(currPosition.y(), screenGeometry.top(), screenGeometry.bottom() - popupSize.height());
+
+    popup->placeAt(QPoint(x, y));
+    popup->raise();
+    popup->fadeIn();
+}
+
+void SearchField::keyPressEvent(QKeyEvent *event) {
+    switch (event->key()) {
+        case Qt::Key_Up:
+        case Qt::Key_Down: {
+            if (popup->isVisible()) {
+                QApplication::sendEvent(popup->list(), event);
+                return;
+            }
+            break;
+        }
+
+        case Qt::Key_Return:
+        case Qt::Key_Enter: {
+            QModelIndex index = popup->list()->currentIndex();
+            if (popup->isVisible() && index.isValid()) {
+                onSuggestionClicked(index);
+                event->accept();
+                return;
+            }
+            break;
+        }
+
+        case Qt::Key_Escape: {
+            if (popup->isVisible()) {
+                cancelQuery();
+                popup->fadeOut();
+                event->accept();
+                return;
+            }
+            break;
+        }
+
+        default: break;
+    }
+
+    TextField::keyPressEvent(event);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "TextField.h"
+#include "Popup.h"
+#include "Delegate.h"
+#include "SuggestionProvider.h"
+#include "../../resources/IconManager.h"
+
+#include <QObject>
+#include <QEvent>
+#include <QApplication>
+#include <QScreen>
+#include <QKeyEvent>
+#include <QListView>
+#include <QStandardItemModel>
+#include <QStandardItem>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QStringList>
+#include <memory>
+
+class SearchField : public TextField {
+    Q_OBJECT
+
+    public:
+    explicit SearchField(QWidget *parent = nullptr);
+
+    /**
+     * @brief Provider is queried on the global thread pool. Each new query cancels the one in flight.
+     */
+    void setSuggestionProvider(std::shared_ptr<SuggestionProvider> provider);
+    void setDarkMode(bool value) override;
+    void setMaxVisibleItems(int items);
+    void setMinimumQueryLength(int length);
+
+    QStringList suggestions() const;
+    bool isQueryRunning() const;
+
+    signals:
+    void suggestionActivated(const QString &text);
+    void suggestionsFinished();
+
+    private slots:
+    void onQueryTextChanged(const QString &text);
+    void onSuggestionClicked(const QModelIndex &index);
+
+    protected:
+    void keyPressEvent(QKeyEvent *event) override;
+
+    private:
+    void init();
+    void cancelQuery();
+    void appendSuggestions(int begin, int end);
+    void finishQuery();
+    void positionPopup();
+
+    // Provider
+    std::shared_ptr<SuggestionProvider> provider;
+    QFutureWatcher<QStringList> *watcher = nullptr;
+    int minimumQueryLength = 1;
+    QString activatedText;
+
+    // Flags
+    bool isDarkMode = false;
+
+    // Icon
+    const QString SearchIcon = IconManager::icon(Icons::Search);
+
+    // Results Popup
+    Popup *popup = nullptr;
+    Delegate *delegate = nullptr;
+    QStandardItemModel model;
+};
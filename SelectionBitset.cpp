@@ -0,0 +1,160 @@
+#include "SelectionBitset.h"
+
+int SelectionBitset::wordsFor(int bits) { return (bits + 63) / 64; }
+
+quint64 SelectionBitset::lowMask(int bits) {
+    if (bits <= 0) 
+        return 0;
+    return bits >= 64 ? ~quint64(0) : (quint64(1) << bits) - 1;
+}
+
+void SelectionBitset::resize(int count) {
+    bits = std::max(count, 0);
+    words.resize(wordsFor(bits), 0);
+    trimTail();
+}
+
+int SelectionBitset::size() const { return bits; }
+
+bool SelectionBitset::test(int row) const {
+    if (row < 0 || row >= bits) 
+        return false;
+    return (words[row >> 6] >> (row & 63)) & 1;
+}
+
+void SelectionBitset::set(int row, bool on) {
+    if (row < 0 || row >= bits) 
+        return;
+
+    const quint64 bit = quint64(1) << (row & 63);
+    if (on) 
+        words[row >> 6] |= bit;
+    else 
+        words[row >> 6] &= ~bit;
+}
+
+void SelectionBitset::toggle(int row) {
+    if (row >= 0 && row < bits) 
+        words[row >> 6] ^= quint64(1) << (row & 63);
+}
+
+void SelectionBitset::selectAll() {
+    std::fill(words.begin(), words.end(), ~quint64(0));
+    trimTail();
+}
+
+void SelectionBitset::clear() { std::fill(words.begin(), words.end(), 0); }
+
+void SelectionBitset::invert() {
+    for (quint64 &word : words) 
+        word = ~word;
+    trimTail();
+}
+
+void SelectionBitset::setRows(const std::vector<int> &rows, bool on) {
+    for (int row : rows) 
+        set(row, on);
+}
+
+int SelectionBitset::count() const {
+    int total = 0;
+    for (quint64 word : words) 
+        total += qPopulationCount(word);
+    return total;
+}
+
+bool SelectionBitset::any() const {
+    return std::any_of(words.begin(), words.end(), [](quint64 word) { return word != 0; });
+}
+
+std::vector<int> SelectionBitset::rows() const {
+    std::vector<int> result;
+    result.reserve(count());
+
+    for (int w = 0; w < int(words.size()); ++w) {
+        // Walk set bits only
+        for (quint64 word = words[w]; word; word &= word - 1) 
+            result.push_back(w * 64 + qCountTrailingZeroBits(word));
+    }
+
+    return result;
+}
+
+void SelectionBitset::insert(int first, int count) {
+    if (count <= 0 || first < 0 || first > bits) 
+        return;
+
+    const std::vector<quint64> source = words;
+    const int gapEnd = first + count;
+
+    bits += count;
+    words.resize(wordsFor(bits), 0);
+
+    // Bits below first stay, the gap is cleared, bits from gapEnd on come from count rows earlier
+    for (int w = first >> 6; w < int(words.size()); ++w) {
+        const qint64 pos = qint64(w) * 64;
+        const quint64 below = w < int(source.size()) ? source[w] & lowMask(int(first - pos)) : 0;
+        const quint64 above = bitsAt(source, pos - count) & ~lowMask(int(std::min<qint64>(gapEnd - pos, 64)));
+        words[w] = below | above;
+    }
+
+    trimTail();
+}
+
+void SelectionBitset::remove(int first, int count) {
+    if (count <= 0 || first < 0 || first >= bits) 
+        return;
+    count = std::min(count, bits - first);
+
+    const int firstWord = first >> 6;
+    const quint64 keep = lowMask(first & 63);
+
+    // Bits from first on are replaced by the ones count rows later
+    for (int w = firstWord; w < int(words.size()); ++w) {
+        const qint64 pos = qint64(w) * 64;
+        const quint64 moved = bitsAt(words, pos + count);
+        words[w] = w == firstWord ? (words[w] & keep) | (moved & ~keep) : moved;
+    }
+
+    bits -= count;
+    words.resize(wordsFor(bits));
+    trimTail();
+}
+
+void SelectionBitset::move(int first, int count, int destination) {
+    if (count <= 0 || first < 0 || first + count > bits || (destination >= first && destination <= first + count)) 
+        return;
+
+    std::vector<bool> moved(count);
+    for (int i = 0; i < count; ++i) 
+        moved[i] = test(first + i);
+
+    remove(first, count);
+    const int to = destination > first ? destination - count : destination;
+    insert(to, count);
+
+    for (int i = 0; i < count; ++i) 
+        set(to + i, moved[i]);
+}
+
+quint64 SelectionBitset::bitsAt(const std::vector<quint64> &words, qint64 pos) {
+    // 64 bits starting at pos, zero outside the vector
+    if (pos <= -64) 
+        return 0;
+    if (pos < 0) 
+        return words.empty() ? 0 : words[0] << int(-pos);
+
+    const int s = int(pos & 63);
+    const size_t w = size_t(pos >> 6);
+
+    quint64 value = w < words.size() ? words[w] >> s : 0;
+    if (s && w + 1 < words.size()) 
+        value |= words[w + 1] << (64 - s);
+    return value;
+}
+
+void SelectionBitset::trimTail() {
+    // Bits past the last row stay zero so count() and any() need no masking
+    if (bits % 64 && !words.empty()) 
+        words.back() &= lowMask(bits % 64);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Row membership packed 64 rows per word. Bulk operations work a word at a time,
+ * so select all / invert over thousands of rows are a few hundred plain loop iterations.
+ */
+class SelectionBitset {
+    public:
+    void resize(int count);
+    int size() const;
+
+    bool test(int row) const;
+    void set(int row, bool on = true);
+    void toggle(int row);
+
+    void selectAll();
+    void clear();
+    void invert();
+
+    /**
+     * @brief Sets or clears every listed row, e.g. the current filter matches.
+     */
+    void setRows(const std::vector<int> &rows, bool on = true);
+
+    int count() const;
+    bool any() const;
+    std::vector<int> rows() const;
+
+    /**
+     * @brief Keep membership aligned with the model when rows are inserted (unselected) or removed.
+     */
+    void insert(int first, int count);
+    void remove(int first, int count);
+
+    /**
+     * @brief Same as QAbstractItemModel::beginMoveRows(), destination is counted before the move.
+     */
+    void move(int first, int count, int destination);
+
+    private:
+    static int wordsFor(int bits);
+    static quint64 lowMask(int bits);
+    static quint64 bitsAt(const std::vector<quint64> &words, qint64 pos);
+    void trimTail();
+
+    std::vector<quint64> words;
+    int bits = 0;
+};
@@ -0,0 +1,131 @@
+#include "ShortcutRegistry.h"
+
+ShortcutRegistry::ShortcutRegistry(QObject *parent) : QObject(parent) {}
+
+ShortcutRegistry *ShortcutRegistry::instance() {
+    static ShortcutRegistry *registry = new ShortcutRegistry(qApp);
+    return registry;
+}
+
+QKeySequence ShortcutRegistry::parse(const QString &shortcut) {
+    // Menus show "Ctrl + C", QKeySequence wants "Ctrl+C"
+    static const QRegularExpression spacedPlus("\\s*\\+\\s*");
+
+    // Most actions have no shortcut, they skip the regex entirely
+    if (shortcut.isEmpty())
+        return QKeySequence();
+
+    QString text = shortcut.trimmed();
+    text.replace(spacedPlus, "+");
+
+    return QKeySequence::fromString(text, QKeySequence::PortableText);
+}
+
+bool ShortcutRegistry::add(const QKeySequence &sequence, const Handler &handler, QObject *owner, QWidget *scope) {
+    if (sequence.isEmpty() || !handler)
+        return false;
+
+    auto it = shortcuts.find(sequence);
+    if (it != shortcuts.end() && isLive(*it))
+        return false;
+
+    shortcuts.insert(sequence, { handler, owner, scope, owner != nullptr, scope != nullptr });
+
+    if (owner)
+        connect(owner, &QObject::destroyed, this, &ShortcutRegistry::prune, Qt::UniqueConnection);
+    if (scope)
+        connect(scope, &QObject::destroyed, this, &ShortcutRegistry::prune, Qt::UniqueConnection);
+
+    updateFilter();
+    return true;
+}
+
+void ShortcutRegistry::remove(const QKeySequence &sequence) {
+    shortcuts.remove(sequence);
+    updateFilter();
+}
+
+void ShortcutRegistry::removeOwner(QObject *owner) {
+    shortcuts.removeIf([owner](QHash<QKeySequence, Entry>::iterator it) { return it->owner == owner; });
+    updateFilter();
+}
+
+bool ShortcutRegistry::contains(const QKeySequence &sequence) const {
+    auto it = shortcuts.constFind(sequence);
+    return it != shortcuts.constEnd() && isLive(*it);
+}
+
+bool ShortcutRegistry::trigger(const QKeySequence &sequence) {
+    auto it = shortcuts.find(sequence);
+    if (it == shortcuts.end())
+        return false;
+
+    if (!isLive(*it)) {
+        shortcuts.erase(it);
+        updateFilter();
+        return false;
+    }
+
+    if (it->hasScope && !it->scope->window()->isActiveWindow())
+        return false;
+
+    // The handler may add or remove shortcuts, so it runs from a copy
+    const Handler handler = it->handler;
+    handler();
+
+    emit activated(sequence);
+    return true;
+}
+
+bool ShortcutRegistry::isLive(const Entry &entry) const {
+    return (!entry.hasOwner || entry.owner) && (!entry.hasScope || entry.scope);
+}
+
+void ShortcutRegistry::prune() {
+    shortcuts.removeIf([this](QHash<QKeySequence, Entry>::iterator it) { return !isLive(*it); });
+    updateFilter();
+}
+
+void ShortcutRegistry::updateFilter() {
+    const bool needed = !shortcuts.isEmpty();
+
+    if (needed == isFiltering)
+        return;
+
+    isFiltering = needed;
+    isFiltering ? qApp->installEventFilter(this) : qApp->removeEventFilter(this);
+}
+
+bool ShortcutRegistry::eventFilter(QObject *obj, QEvent *event) {
+    if (event->type() != QEvent::KeyPress)
+        return QObject::eventFilter(obj, event);
+
+    auto *keyEvent = static_cast<QKeyEvent*>(event);
+
+    switch (keyEvent->key()) {
+        case Qt::Key_Control:
+        case Qt::Key_Shift:
+        case Qt::Key_Alt:
+        case Qt::Key_Meta:
+        case Qt::Key_unknown:
+            return QObject::eventFilter(obj, event);
+
+        default: break;
+    }
+
+    const QKeySequence sequence(QKeyCombination(keyEvent->modifiers() & ~Qt::KeypadModifier, Qt::Key(keyEvent->key())));
+    if (!shortcuts.contains(sequence))
+        return QObject::eventFilter(obj, event);
+
+    // Keys the focus widget handles itself (Ctrl + C in a text field) stay with it
+    if (QWidget *focus = QApplication::focusWidget()) {
+        QKeyEvent override(QEvent::ShortcutOverride, keyEvent->key(), keyEvent->modifiers(), keyEvent->text());
+        override.ignore();
+        QCoreApplication::sendEvent(focus, &override);
+
+        if (override.isAccepted())
+            return QObject::eventFilter(obj, event);
+    }
+
+    return trigger(sequence) || QObject::eventFilter(obj, event);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QObject>
+#include <QWidget>
+#include <QPointer>
+#include <QHash>
+#include <QKeySequence>
+#include <QKeyEvent>
+#include <QApplication>
+#include <QRegularExpression>
+#include <functional>
+
+/**
+ * @brief Application-wide table from key sequences to actions, so a key press reaches its action
+ * with one hash lookup and without opening any menu. The application event filter is only
+ * installed while at least one shortcut is registered. Single-chord sequences only.
+ */
+class ShortcutRegistry : public QObject {
+    Q_OBJECT
+
+    public:
+    using Handler = std::function<void()>;
+
+    static ShortcutRegistry *instance();
+
+    /**
+     * @brief Parses display strings such as "Ctrl + Shift + S" into a key sequence.
+     */
+    static QKeySequence parse(const QString &shortcut);
+
+    /**
+     * @param owner The shortcut is dropped once the owner is destroyed.
+     * @param scope If given, the shortcut only fires while the scope's window is active.
+     * @return false if the sequence is empty or already taken.
+     */
+    bool add(const QKeySequence &sequence, const Handler &handler, QObject *owner = nullptr, QWidget *scope = nullptr);
+    void remove(const QKeySequence &sequence);
+    void removeOwner(QObject *owner);
+    bool contains(const QKeySequence &sequence) const;
+
+    /**
+     * @brief Runs the handler bound to the sequence, as a matching key press would.
+     */
+    bool trigger(const QKeySequence &sequence);
+
+    signals:
+    void activated(const QKeySequence &sequence);
+
+    protected:
+    bool eventFilter(QObject *obj, QEvent *event) override;
+
+    private:
+    explicit ShortcutRegistry(QObject *parent = nullptr);
+
+    struct Entry {
+        Handler handler;
+        QPointer<QObject> owner;
+        QPointer<QWidget> scope;
+        bool hasOwner = false;
+        bool hasScope = false;
+    };
+
+    bool isLive(const Entry &entry) const;
+    void prune();
+    void updateFilter();
+
+    QHash<QKeySequence, Entry> shortcuts;
+    bool isFiltering = false;
+};
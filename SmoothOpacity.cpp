@@ -10,4 +10,37 @@ void SmoothOpacity::setOpacity(qreal op) {
 
 qreal SmoothOpacity::getOpacity() { 
   return QGraphicsOpacityEffect::opacity();
-}
\ No newline at end of file
+}
+
+void SmoothOpacity::setSnapshotMode(bool enable) {
+  snapshotMode = enable;
+  snapshot = QPixmap();
+  update();
+}
+
+void SmoothOpacity::draw(QPainter *painter) {
+  if (!snapshotMode) {
+    QGraphicsOpacityEffect::draw(painter);
+    return;
+  }
+
+  if (snapshot.isNull()) 
+    snapshot = sourcePixmap(Qt::DeviceCoordinates, &snapshotOffset, QGraphicsEffect::NoPad);
+
+  if (snapshot.isNull()) 
+    return;
+
+  painter->save();
+  painter->setWorldTransform(QTransform());
+  painter->setOpacity(opacity());
+  painter->drawPixmap(snapshotOffset, snapshot);
+  painter->restore();
+}
+
+void SmoothOpacity::sourceChanged(ChangeFlags flags) {
+  // Content updates are ignored on purpose, geometry changes are not
+  if (flags & (SourceAttached | SourceDetached | SourceBoundingRectChanged)) 
+    snapshot = QPixmap();
+
+  QGraphicsOpacityEffect::sourceChanged(flags);
+}
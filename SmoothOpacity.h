@@ -2,6 +2,9 @@
 
 #include <QGraphicsOpacityEffect>
 #include <QWidget>
+#include <QPainter>
+#include <QPixmap>
+#include <QTransform>
 
 class SmoothOpacity : public QGraphicsOpacityEffect {
    Q_OBJECT
@@ -11,4 +14,19 @@ class SmoothOpacity : public QGraphicsOpacityEffect {
    explicit SmoothOpacity(QWidget *parent = nullptr);
    void setOpacity(qreal op);
    qreal getOpacity();
+
+   /**
+    * @brief Renders the source once and fades the cached pixmap, instead of re-rendering
+    * the whole subtree on every frame. Only suitable while the content is static.
+    */
+   void setSnapshotMode(bool enable);
+
+   protected:
+   void draw(QPainter *painter) override;
+   void sourceChanged(ChangeFlags flags) override;
+
+   private:
+   bool snapshotMode = false;
+   QPixmap snapshot;
+   QPoint snapshotOffset;
 };
@@ -4,12 +4,10 @@ SpinnerProgress::SpinnerProgress(QWidget *parent) : QWidget(parent) {
    hide();
    setAttribute(Qt::WA_TranslucentBackground, true);
 
-   opacity = new SmoothOpacity;
-   setGraphicsEffect(opacity);
-
-   animation = new QPropertyAnimation(opacity, "opacity");
-   animation->setDuration(300);
-   animation->setEasingCurve(QEasingCurve::InOutQuad);
+   // Content keeps animating while fading, so no snapshot
+   fader = new Fader(this);
+   fader->setLiveContent(true);
+   connect(fader, &Fader::fadedOut, this, &QWidget::hide);
 
    loadDefaultColors();
 }
@@ -32,22 +30,11 @@ void SpinnerProgress::setFixedSize(QSize s, bool isButton) {
 }
 
 void SpinnerProgress::fadeIn() {
-   animation->stop();
-   disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-   animation->setStartValue(0.0);
-   animation->setEndValue(1.0);
-   animation->start();
+   fader->fadeIn();
    show();
 }
 
-void SpinnerProgress::fadeOut() {
-   animation->stop();
-   disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-   animation->setStartValue(1.0);
-   animation->setEndValue(0.0);
-   connect(animation, &QPropertyAnimation::finished, this, &QWidget::hide);
-   animation->start();
-}
+void SpinnerProgress::fadeOut() { fader->fadeOut(); }
 
 void SpinnerProgress::start() {
    if (timer && !timer->isActive() && isIndeterminate) 
@@ -1,5 +1,5 @@
 #pragma once
-#include "SmoothOpacity.h"
+#include "Fader.h"
 
 #include <QWidget>
 #include <QPainter>
@@ -72,7 +72,6 @@ class SpinnerProgress : public QWidget {
    QTimer *timer = nullptr;
    QString loaderText;
 
-   QPropertyAnimation *animation = nullptr;
-   SmoothOpacity *opacity = nullptr;
+   Fader *fader = nullptr;
 };
 
@@ -0,0 +1,36 @@
+#include "StreamDrainer.h"
+
+StreamDrainer::StreamDrainer(const Step &step, QObject *parent) : QObject(parent), step(step) {
+    connect(&timer, &QTimer::timeout, this, &StreamDrainer::runSlice);
+}
+
+void StreamDrainer::start() {
+    timer.start(0);
+}
+
+void StreamDrainer::stop() { timer.stop(); }
+bool StreamDrainer::isRunning() const { return timer.isActive(); }
+
+void StreamDrainer::setFrameBudget(int ms) { budget = std::max(ms, 1); }
+void StreamDrainer::setBatchSize(int items) { batchSize = std::max(items, 1); }
+
+quint64 StreamDrainer::drainedCount() const { return drained; }
+
+void StreamDrainer::runSlice() {
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    int taken = 0;
+    do {
+        taken = step(batchSize);
+        if (taken < 0) {
+            timer.stop();
+            emit finished();
+            return;
+        }
+        drained += taken;
+    } while (taken > 0 && elapsed.elapsed() < budget);
+
+    // Poll at frame rate while the producer is idle, back to back while it keeps up
+    timer.setInterval(taken > 0 ? 0 : 16);
+}
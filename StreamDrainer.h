@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+#include <algorithm>
+
+/**
+ * @brief Runs a drain step on the GUI thread in frame-budgeted slices until the stream is done.
+ * Each slice calls the step with a batch size until the budget is spent or the step returns 0,
+ * so painting and input keep running while items arrive.
+ */
+class StreamDrainer : public QObject {
+    Q_OBJECT
+
+    public:
+    /**
+     * @brief Moves up to maxItems into the view and returns how many it took, or -1 when the stream is finished.
+     */
+    using Step = std::function<int(int maxItems)>;
+
+    explicit StreamDrainer(const Step &step, QObject *parent = nullptr);
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    /**
+     * @brief Time per slice in milliseconds. Default is 4 ms, like the IdleScheduler.
+     */
+    void setFrameBudget(int ms);
+    void setBatchSize(int items);
+
+    quint64 drainedCount() const;
+
+    signals:
+    void finished();
+
+    private:
+    void runSlice();
+
+    Step step;
+    QTimer timer;
+    int budget = 4;
+    int batchSize = 512;
+    quint64 drained = 0;
+};
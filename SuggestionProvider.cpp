@@ -0,0 +1,43 @@
+#include "SuggestionProvider.h"
+
+StaticSuggestionProvider::StaticSuggestionProvider(const QStringList &entries, int latencyMs, int batchSize) 
+    : _entries(entries), _latencyMs(latencyMs), _batchSize(std::max(batchSize, 1)) {}
+
+bool StaticSuggestionProvider::wait(int ms, QPromise<QStringList> &promise) const {
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    // Sleep in small steps so a cancelled query releases its worker quickly
+    while (elapsed.elapsed() < ms) {
+        if (promise.isCanceled()) 
+            return false;
+        QThread::msleep(5);
+    }
+
+    return !promise.isCanceled();
+}
+
+void StaticSuggestionProvider::query(const QString &text, QPromise<QStringList> &promise) {
+    QStringList batch;
+    batch.reserve(_batchSize);
+
+    for (const QString &entry : _entries) {
+        if (promise.isCanceled()) 
+            return;
+
+        if (!entry.contains(text, Qt::CaseInsensitive)) 
+            continue;
+
+        batch.append(entry);
+
+        if (batch.size() == _batchSize) {
+            if (!wait(_latencyMs, promise)) 
+                return;
+            promise.addResult(batch);
+            batch.clear();
+        }
+    }
+
+    if (!batch.isEmpty() && wait(_latencyMs, promise))
+        promise.addResult(batch);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QPromise>
+#include <QThread>
+#include <QElapsedTimer>
+
+class SuggestionProvider {
+    public:
+    virtual ~SuggestionProvider() = default;
+
+    /**
+     * @brief Called on a worker thread for every new query.
+     * Push partial results with promise.addResult() as soon as they are found, and
+     * return early once promise.isCanceled() turns true (newer input arrived).
+     * @warning Must not touch any widget.
+     */
+    virtual void query(const QString &text, QPromise<QStringList> &promise) = 0;
+};
+
+/**
+ * @brief In-process provider over a fixed list, with optional artificial latency per batch.
+ * Handy as a stand-in for a real backend while testing.
+ */
+class StaticSuggestionProvider : public SuggestionProvider {
+    public:
+    explicit StaticSuggestionProvider(const QStringList &entries, int latencyMs = 0, int batchSize = 16);
+
+    void query(const QString &text, QPromise<QStringList> &promise) override;
+
+    private:
+    bool wait(int ms, QPromise<QStringList> &promise) const;
+
+    const QStringList _entries;
+    const int _latencyMs;
+    const int _batchSize;
+};
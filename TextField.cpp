@@ -168,6 +168,73 @@ void TextField::setTextColor(const TextFieldTextColor &state, const QColor &colo
     updateStyle();
 }
 
+void TextField::setDebounceInterval(int ms) { debounceTimer->setInterval(std::max(ms, 0)); }
+int TextField::debounceInterval() const { return debounceTimer->interval(); }
+
+void TextField::setAsyncValidator(const AsyncValidator &validator) {
+    asyncValidator = validator;
+    ++(*validationSerial);
+
+    if (!asyncValidator) {
+        setValidationState(Unvalidated);
+        return;
+    }
+
+    setValidationState(Pending);
+    debounceTimer->start();
+}
+
+TextField::ValidationState TextField::validationState() const { return _validationState; }
+
+void TextField::setValidationState(ValidationState state) {
+    if (_validationState == state)
+        return;
+
+    _validationState = state;
+    emit validationStateChanged(_validationState);
+    update();
+}
+
+void TextField::onTextChanged() {
+    // Every keystroke supersedes whatever validation is still in flight
+    ++(*validationSerial);
+
+    if (asyncValidator)
+        setValidationState(Pending);
+
+    debounceTimer->start();
+}
+
+void TextField::onDebounceTimeout() {
+    const QString current = text();
+    emit textChangedDebounced(current);
+
+    if (!asyncValidator)
+        return;
+
+    const quint64 serial = validationSerial->load();
+    std::shared_ptr<std::atomic<quint64>> liveSerial = validationSerial;
+    AsyncValidator validator = asyncValidator;
+
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, serial]() {
+        watcher->deleteLater();
+
+        if (serial != validationSerial->load())
+            return;
+
+        setValidationState(watcher->result() ? Valid : Invalid);
+    });
+
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [validator, current, liveSerial, serial]() {
+        // Skip the work entirely if newer input arrived while queued
+        if (serial != liveSerial->load())
+            return false;
+
+        return validator(current);
+    }));
+}
+
 void TextField::setBorderTransparent(bool enable) { isBorderTransparent = enable; }
 void TextField::setNormalBackgroundTransparent(bool enable) { isBackgroundTransparent = enable; }
 
@@ -181,6 +248,8 @@ void TextField::paintEvent(QPaintEvent *event) {
     QColor penColor = isFocused ? color(TextFieldColor::BorderFocused)
                                     : (isDarkMode ? color(TextFieldColor::BorderDark)
                                                   : color(TextFieldColor::BorderLight));
+    if (_validationState == Pending) penColor = color(TextFieldColor::BorderPending);
+    if (_validationState == Invalid) penColor = color(TextFieldColor::BorderInvalid);
     if (isBorderTransparent) penColor = Qt::transparent;
 
     QPen pen(penColor, isFocused ? 1.0 : 0.5);
@@ -256,6 +325,19 @@ void TextField::leaveEvent(QEvent *event) {
 void TextField::focusInEvent(QFocusEvent *event) {
     if (!isReadOnly)
         isFocused = true;
+
+    // Build the shared context menu before the first right-click
+    if (hasContextMenu && !isReadOnly) {
+        const bool darkMode = isDarkMode;
+
+        IdleScheduler::instance()->schedule(QString("TextField:ContextMenu:%1").arg(darkMode), [darkMode]() {
+            Menu *menu = sharedContextMenu(darkMode);
+            menu->ensurePolished();
+            menu->delegate()->prewarm(menu->model(), 0, menu->maxVisibleItems());
+            PopupWindowPool::prewarm(PopupWindow::PopupKind);
+            return false;
+        }, IdleScheduler::Low);
+    }
     
     if (clear) clear->setVisible(!text().isEmpty());
 
@@ -285,42 +367,81 @@ void TextField::focusOutEvent(QFocusEvent *event) {
     update();
 }
 
-void TextField::contextMenuEvent(QContextMenuEvent *event) {
-    if (!hasContextMenu || !isReadOnly) 
-        return;
+// Field the shared context menu is currently open for
+static QPointer<TextField> contextMenuTarget;
+
+Menu *TextField::sharedContextMenu(bool darkMode) {
+    // One menu per theme, created on first use and reused for every field
+    static QPointer<Menu> menus[2];
+    QPointer<Menu> &menu = menus[darkMode ? 1 : 0];
 
-    menu = new Menu(this);
+    if (menu)
+        return menu;
+
+    menu = new Menu(nullptr);
     menu->setMaxVisibleItems(12);
     menu->setItemSize(QSize(180, 36));
-    menu->setDarkMode(isDarkMode);
+    menu->setDarkMode(darkMode);
     menu->setIconic(true);
 
-    const bool hasText = !this->text().isEmpty();
-    const bool hasSelection = this->hasSelectedText();
+    // Rows follow ContextAction order
+    const QString CopyIcon      =  IconManager::icon(Icons::Copy);
+    const QString CutIcon       =  IconManager::icon(Icons::Cut);
+    const QString DeleteIcon    =  IconManager::icon(Icons::MenuDelete);
+    const QString PasteIcon     =  IconManager::icon(Icons::Paste);
+    const QString SelectAllIcon =  IconManager::icon(Icons::SelectAll);
+    const QString UndoIcon      =  IconManager::icon(Icons::Undo);
+    const QString RedoIcon      =  IconManager::icon(Icons::Redo);
+
+    menu->addAction({ CopyAction,       "Copy",        "Ctrl + C",  CopyIcon,       CopyIcon });
+    menu->addAction({ CutAction,        "Cut",         "Ctrl + X",  CutIcon,        CutIcon });
+    menu->addAction({ DeleteAction,     "Delete",      "Delete",    DeleteIcon,     DeleteIcon });
+    menu->addAction({ PasteAction,      "Paste",       "Ctrl + V",  PasteIcon,      PasteIcon });
+    menu->addAction({ SelectAllAction,  "Select All",  "Ctrl + A",  SelectAllIcon,  SelectAllIcon });
+    menu->addAction({ UndoAction,       "Undo",        "Ctrl + Z",  UndoIcon,       UndoIcon });
+    menu->addAction({ RedoAction,       "Redo",        "Ctrl + Y",  RedoIcon,       RedoIcon });
+
+    // Dispatch by action id, QLineEdit already handles the shortcuts itself
+    Menu *m = menu;
+    connect(m, &Menu::actionTriggered, m, [](int action) {
+        if (contextMenuTarget)
+            contextMenuTarget->triggerContextAction(action);
+    });
+
+    return menu;
+}
 
-    if (hasSelection) {
-        menu->addAction({ "Copy",    false,  "Ctrl + C",  CopyIcon,    CopyIcon });
-        menu->addAction({ "Cut",     false,  "Ctrl + X",  CutIcon,     CutIcon });
-        menu->addAction({ "Delete",  false,  "Delete",    DeleteIcon,  DeleteIcon });
+void TextField::triggerContextAction(int action) {
+    switch (action) {
+        case CopyAction:      copy();      break;
+        case CutAction:       cut();       break;
+        case DeleteAction:    del();       break;
+        case PasteAction:     paste();     break;
+        case SelectAllAction: selectAll(); break;
+        case UndoAction:      undo();      break;
+        case RedoAction:      redo();      break;
+        default: qDebug() << "Unknown context menu action:" << action;
     }
+}
 
-    menu->addAction({ "Paste", false, "Ctrl + V", PasteIcon, PasteIcon});
-    
-    if (hasText && !hasSelection) menu->addAction({ "Select All",  false,  "Ctrl + A",  SelectAllIcon,  SelectAllIcon});
-    if (this->isUndoAvailable())  menu->addAction({ "Undo",        false,  "Ctrl + Z",  UndoIcon,       UndoIcon});
-    if (this->isRedoAvailable())  menu->addAction({ "Redo",        false,  "Ctrl + Y",  RedoIcon,       RedoIcon});
-
-    connect(menu, &Menu::itemClicked, this, [=]() {
-        QString action = menu->clickedItemText();
-        if (action == "Copy") copy();
-        else if (action == "Cut") cut();
-        else if (action == "Paste") paste();
-        else if (action == "Delete") del();
-        else if (action == "Select All") selectAll();
-        else if (action == "Undo") undo();
-        else if (action == "Redo") redo();
-        else qDebug() << "Unknown context menu action:" << action;
-    });
+void TextField::contextMenuEvent(QContextMenuEvent *event) {
+    if (!hasContextMenu || isReadOnly) 
+        return;
+
+    Menu *menu = sharedContextMenu(isDarkMode);
+    menu->setAnchorWidget(this);
+    contextMenuTarget = this;
+
+    const bool hasText = !this->text().isEmpty();
+    const bool hasSelection = this->hasSelectedText();
+
+    menu->setActionEnabled(CopyAction, hasSelection);
+    menu->setActionEnabled(CutAction, hasSelection);
+    menu->setActionEnabled(DeleteAction, hasSelection);
+    menu->setActionEnabled(PasteAction, true);
+    menu->setActionEnabled(SelectAllAction, hasText && !hasSelection);
+    menu->setActionEnabled(UndoAction, this->isUndoAvailable());
+    menu->setActionEnabled(RedoAction, this->isRedoAvailable());
 
     menu->show();
     menu->move(event->globalPos());
@@ -343,6 +464,14 @@ void TextField::init() {
     animate = new QPropertyAnimation(effect, "blurRadius", this);
     animate->setDuration(300);
     animate->setEasingCurve(QEasingCurve::InOutQuad);
+
+    // Debounced Text Change
+    debounceTimer = new QTimer(this);
+    debounceTimer->setSingleShot(true);
+    debounceTimer->setInterval(300);
+
+    connect(this, &QLineEdit::textChanged, this, &TextField::onTextChanged);
+    connect(debounceTimer, &QTimer::timeout, this, &TextField::onDebounceTimeout);
 }
 
 void TextField::loadDefaultColors() {
@@ -350,6 +479,8 @@ void TextField::loadDefaultColors() {
     _colors[TextFieldColor::BorderFocused] = QColor("#0191DF");      // focused border
     _colors[TextFieldColor::BorderLight]   = QColor("#CCCCCC");      // light mode normal border
     _colors[TextFieldColor::BorderDark]    = QColor("#4D4D4D");      // dark mode normal border
+    _colors[TextFieldColor::BorderPending] = QColor("#FFB900");      // validation in flight
+    _colors[TextFieldColor::BorderInvalid] = QColor("#E81123");      // validation failed
 
     // Background colors
     _colors[TextFieldColor::FocusedLight]  = QColor("#FFFFFF");      // focused background light
@@ -3,6 +3,7 @@
 #include "Button.h"
 #include "Menu.h"
 #include "SmoothShadow.h"
+#include "IdleScheduler.h"
 #include "../../resources/IconManager.h"
 
 #include <QResizeEvent>
@@ -13,6 +14,13 @@
 #include <algorithm>
 #include <QLineEdit>
 #include <QHash>
+#include <QPointer>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+#include <functional>
+#include <atomic>
+#include <memory>
 
 class TextField : public QLineEdit {
   Q_OBJECT
@@ -39,8 +47,20 @@ class TextField : public QLineEdit {
 
     NormalLight,
     NormalDark,
+
+    BorderPending,
+    BorderInvalid,
+  };
+
+  enum ValidationState {
+    Unvalidated,
+    Pending,
+    Valid,
+    Invalid,
   };
 
+  using AsyncValidator = std::function<bool(const QString &text)>;
+
   explicit TextField(const QString &text, QWidget *parent = nullptr);
   explicit TextField(QWidget *parent = nullptr);
   
@@ -62,10 +82,27 @@ class TextField : public QLineEdit {
   void setColor(const TextFieldColor &state, const QColor &color);
   void setTextColor(const TextFieldTextColor &state, const QColor &color);
 
+  /**
+   * @brief Quiet period after the last keystroke before textChangedDebounced() is emitted. Default is 300 ms.
+   */
+  void setDebounceInterval(int ms);
+  int debounceInterval() const;
+
+  /**
+   * @brief Validator runs on the global thread pool once typing settles. Results superseded by newer input are dropped.
+   * @warning The validator is called from a worker thread, it must not touch any widget.
+   */
+  void setAsyncValidator(const AsyncValidator &validator);
+  ValidationState validationState() const;
+
   inline uint qHash(const TextFieldColor &state, uint seed = 0) {
     return ::qHash(static_cast<int>(state), seed);
   }
 
+  signals:
+  void textChangedDebounced(const QString &text);
+  void validationStateChanged(TextField::ValidationState state);
+
   protected:
   void paintEvent(QPaintEvent *event) override;
   void enterEvent(QEnterEvent *event) override;
@@ -81,6 +118,23 @@ class TextField : public QLineEdit {
   void loadDefaultColors();
   void updateStyle();
   void positionButton(Button *button);
+  void onTextChanged();
+  void onDebounceTimeout();
+  void setValidationState(ValidationState state);
+
+  // Context Menu
+  enum ContextAction {
+    CopyAction,
+    CutAction,
+    DeleteAction,
+    PasteAction,
+    SelectAllAction,
+    UndoAction,
+    RedoAction,
+  };
+
+  static Menu *sharedContextMenu(bool darkMode);
+  void triggerContextAction(int action);
 
   QColor color(const TextFieldColor &state) const;
   QColor textColor(const TextFieldTextColor &state) const;
@@ -114,13 +168,6 @@ class TextField : public QLineEdit {
   QHash<TextFieldTextColor, QColor> _textColors;
 
   // Icons
-  const QString CopyIcon      =  IconManager::icon(Icons::Copy);
-  const QString CutIcon       =  IconManager::icon(Icons::Cut);
-  const QString PasteIcon     =  IconManager::icon(Icons::Paste);
-  const QString DeleteIcon    =  IconManager::icon(Icons::MenuDelete);
-  const QString SelectAllIcon =  IconManager::icon(Icons::SelectAll);
-  const QString UndoIcon      =  IconManager::icon(Icons::Undo);
-  const QString RedoIcon      =  IconManager::icon(Icons::Redo);
   const QString ShowIcon      =  IconManager::icon(Icons::Show);     
   const QString HideIcon      =  IconManager::icon(Icons::Hide);   
   const QString ClearIcon     =  IconManager::icon(Icons::Clear);   
@@ -145,6 +192,9 @@ class TextField : public QLineEdit {
   const int fixedHeight = 36;
   const int minWidth = 36;
 
-  // Menu
-  Menu *menu = nullptr;
+  // Debounce & Validation
+  QTimer *debounceTimer = nullptr;
+  AsyncValidator asyncValidator;
+  ValidationState _validationState = Unvalidated;
+  std::shared_ptr<std::atomic<quint64>> validationSerial = std::make_shared<std::atomic<quint64>>(0);
 };
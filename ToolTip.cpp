@@ -13,12 +13,8 @@ ToolTip::ToolTip(QWidget *target, const QString &text, QObject *parent) : QObjec
 
   timer.setSingleShot(true);
 
-  SmoothOpacity *opacityEffect = new SmoothOpacity;
-  tooltipWidget->setGraphicsEffect(opacityEffect);
-
-  animation = new QPropertyAnimation(opacityEffect, "opacity");
-  animation->setEasingCurve(QEasingCurve::InOutQuad);
-  animation->setDuration(300);
+  fader = new Fader(tooltipWidget, this);
+  connect(fader, &Fader::fadedOut, this, &ToolTip::hide);
 
   connect(this, &ToolTip::textEntered, this, &ToolTip::onTextEntered);
   connect(&timer, &QTimer::timeout, this, &ToolTip::onTimeout);
@@ -26,23 +22,20 @@ ToolTip::ToolTip(QWidget *target, const QString &text, QObject *parent) : QObjec
 }
 
 void ToolTip::fadeInAnimation() {
-  animation->stop();
-  disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-  animation->setStartValue(0.0);
-  animation->setEndValue(1.0);
+  OverlayLayer::ensureHosted(tooltipWidget, _target, PopupWindow::ToolTipKind);
+  fader->fadeIn();
   tooltipWidget->show();
-  animation->start();
+
+  PopupManager::instance()->push(tooltipWidget, _target, [this]() { fadeOutAnimation(); });
 }
 
 void ToolTip::fadeOutAnimation() {
-  animation->stop();
-  disconnect(animation, &QPropertyAnimation::finished, nullptr, nullptr);
-  animation->setStartValue(1.0);
-  animation->setEndValue(0.0);
-  connect(animation, &QPropertyAnimation::finished, this, [this]() {
-    if (tooltipWidget) tooltipWidget->hide();
-  });
-  animation->start();
+  PopupManager::instance()->remove(tooltipWidget);
+
+  if (!tooltipWidget || !tooltipWidget->isVisible()) 
+    return;
+
+  fader->fadeOut();
 }
 
 bool ToolTip::eventFilter(QObject *obj, QEvent *event) {
@@ -103,11 +96,6 @@ bool ToolTip::eventFilter(QObject *obj, QEvent *event) {
     }
   }
 
-  if (event->type() == QEvent::ApplicationStateChange) {
-    timer.stop();
-    fadeOutAnimation();
-  }
-  
   return false;
 }
 
@@ -142,7 +130,7 @@ void ToolTip::position(QWidget *target) {
   int x = std::clamp(finalPos.x(), screenArea.left(), screenArea.right() - tooltipSize.width());
   int y = std::clamp(finalPos.y(), screenArea.top(), screenArea.bottom() - tooltipSize.height());
 
-  tooltipWidget->move(QPoint(x, y));
+  OverlayLayer::place(tooltipWidget, target, QPoint(x, y), PopupWindow::ToolTipKind);
 }
 
 void ToolTip::onTextEntered(const QString &text) {
@@ -177,8 +165,8 @@ void ToolTip::setTargetWidget(QWidget *target) {
   if (!target) {
     timer.stop();
 
-    if (animation) 
-      animation->stop();
+    if (fader) 
+      fader->stop();
 
     hide();
     return;
@@ -193,6 +181,9 @@ void ToolTip::onThemeModeChanged(bool enable) {
 }
 
 void ToolTip::hide() {
-  if (tooltipWidget) 
-    tooltipWidget->hide();
+  if (!tooltipWidget) 
+    return;
+
+  tooltipWidget->hide();
+  OverlayLayer::release(tooltipWidget);
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 #include "RoundedBox.h"
-#include "SmoothOpacity.h"
+#include "Fader.h"
+#include "PopupManager.h"
+#include "OverlayLayer.h"
 
 #include <QObject>
 #include <QPropertyAnimation>
 #include <QTimer>
+#include <QPointer>
 #include <QEvent>
 #include <QScreen>
 #include <QApplication>
@@ -34,8 +37,8 @@ class ToolTip : public QObject {
 
   QTimer timer;
   QWidget *_target = nullptr;
-  RoundedBox *tooltipWidget = nullptr;
-  QPropertyAnimation *animation = nullptr;
+  QPointer<RoundedBox> tooltipWidget;
+  Fader *fader = nullptr;
 
   signals:
   void textEntered(const QString &text);
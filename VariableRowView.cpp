@@ -0,0 +1,355 @@
+#include "VariableRowView.h"
+
+VariableRowView::VariableRowView(QWidget *parent) : QListView(parent) {}
+
+void VariableRowView::setVariableRowHeights(bool enable) {
+    if (isVariable == enable) 
+        return;
+
+    isVariable = enable;
+
+    // QListView's own layout stays cheap underneath, it is just not used for geometry
+    if (isVariable) 
+        rebuildHeights();
+    else 
+        heights.clear();
+
+    updateGeometries();
+    viewport()->update();
+}
+
+bool VariableRowView::hasVariableRowHeights() const { return isVariable; }
+
+// Geometry
+int VariableRowView::rowTop(int row) const {
+    if (!isVariable) 
+        return row * sizeHintForRow(0);
+    return int(heights.prefix(row));
+}
+
+int VariableRowView::rowHeight(int row) const {
+    if (!isVariable) 
+        return sizeHintForRow(0);
+    return heights.value(row);
+}
+
+int VariableRowView::rowAtOffset(int y) const {
+    if (!isVariable) 
+        return indexAt(QPoint(0, y - verticalOffset())).row();
+    return heights.indexAt(std::max(y, 0));
+}
+
+int VariableRowView::contentHeight() const { return isVariable ? int(heights.total()) : contentsSize().height(); }
+
+QModelIndex VariableRowView::rowIndex(int row) const {
+    return model() ? model()->index(row, modelColumn(), rootIndex()) : QModelIndex();
+}
+
+std::vector<int> VariableRowView::measureRows(int first, int last) const {
+    std::vector<int> result;
+    if (!model() || last < first) 
+        return result;
+
+    QStyleOptionViewItem option;
+    initViewItemOption(&option);
+
+    // The gap below each row is part of its height
+    result.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = rowIndex(row);
+        QAbstractItemDelegate *delegate = itemDelegateForIndex(index);
+        const int height = delegate ? delegate->sizeHint(option, index).height() : 0;
+        result.push_back(std::max(height, 0) + spacing());
+    }
+
+    return result;
+}
+
+void VariableRowView::rebuildHeights() {
+    const int count = model() ? model()->rowCount(rootIndex()) : 0;
+    heights.assign(measureRows(0, count - 1));
+}
+
+QRect VariableRowView::visualRect(const QModelIndex &index) const {
+    if (!isVariable) 
+        return QListView::visualRect(index);
+
+    if (!index.isValid() || index.row() >= heights.size()) 
+        return QRect();
+
+    const int row = index.row();
+    return QRect(0, rowTop(row) - verticalOffset(), viewport()->width(), rowHeight(row) - spacing());
+}
+
+QModelIndex VariableRowView::indexAt(const QPoint &point) const {
+    if (!isVariable) 
+        return QListView::indexAt(point);
+
+    const int y = point.y() + verticalOffset();
+    if (y < 0 || y >= contentHeight() || point.x() < 0 || point.x() >= viewport()->width()) 
+        return QModelIndex();
+
+    // Points in the gap below a row hit nothing, like in QListView
+    const int row = heights.indexAt(y);
+    if (y >= rowTop(row) + rowHeight(row) - spacing()) 
+        return QModelIndex();
+
+    return rowIndex(row);
+}
+
+int VariableRowView::verticalOffset() const {
+    return isVariable ? verticalScrollBar()->value() : QListView::verticalOffset();
+}
+
+void VariableRowView::updateGeometries() {
+    if (!isVariable) {
+        QListView::updateGeometries();
+        return;
+    }
+
+    QAbstractItemView::updateGeometries();
+
+    const int viewHeight = viewport()->height();
+    verticalScrollBar()->setSingleStep(heights.size() > 0 ? std::max(rowHeight(0), 1) : 20);
+    verticalScrollBar()->setPageStep(viewHeight);
+    verticalScrollBar()->setRange(0, std::max(0, contentHeight() - viewHeight));
+    horizontalScrollBar()->setRange(0, 0);
+}
+
+QSize VariableRowView::viewportSizeHint() const {
+    if (!isVariable) 
+        return QListView::viewportSizeHint();
+    return QSize(QListView::viewportSizeHint().width(), contentHeight());
+}
+
+void VariableRowView::scrollContentsBy(int dx, int dy) {
+    if (!isVariable) {
+        QListView::scrollContentsBy(dx, dy);
+        return;
+    }
+
+    viewport()->scroll(0, dy);
+}
+
+void VariableRowView::scrollTo(const QModelIndex &index, ScrollHint hint) {
+    if (!isVariable) {
+        QListView::scrollTo(index, hint);
+        return;
+    }
+
+    if (!index.isValid()) 
+        return;
+
+    const int top = rowTop(index.row());
+    const int bottom = top + rowHeight(index.row()) - spacing();
+    const int viewHeight = viewport()->height();
+    int value = verticalScrollBar()->value();
+
+    switch (hint) {
+        case PositionAtTop:    value = top; break;
+        case PositionAtBottom: value = bottom - viewHeight; break;
+        case PositionAtCenter: value = top - (viewHeight - (bottom - top)) / 2; break;
+        default:
+            if (top < value) 
+                value = top;
+            else if (bottom > value + viewHeight) 
+                value = bottom - viewHeight;
+            break;
+    }
+
+    verticalScrollBar()->setValue(value);
+}
+
+// Painting
+void VariableRowView::paintEvent(QPaintEvent *event) {
+    if (!isVariable) {
+        QListView::paintEvent(event);
+        return;
+    }
+
+    if (!model() || heights.size() == 0) 
+        return;
+
+    QPainter painter(viewport());
+    QStyleOptionViewItem baseOption;
+    initViewItemOption(&baseOption);
+
+    const QRect area = event->rect();
+    const int first = rowAtOffset(area.top() + verticalOffset());
+    const int last = rowAtOffset(area.bottom() + verticalOffset());
+
+    const QModelIndex hovered = viewport()->underMouse() ? indexAt(viewport()->mapFromGlobal(QCursor::pos())) : QModelIndex();
+    const QModelIndex current = currentIndex();
+
+    // Only the rows intersecting the exposed area
+    for (int row = first; row <= last && row >= 0; ++row) {
+        const QModelIndex index = rowIndex(row);
+        QStyleOptionViewItem option = baseOption;
+        option.rect = visualRect(index);
+
+        if (!(model()->flags(index) & Qt::ItemIsEnabled)) 
+            option.state &= ~QStyle::State_Enabled;
+        if (selectionModel() && selectionModel()->isSelected(index)) 
+            option.state |= QStyle::State_Selected;
+        if (index == hovered) 
+            option.state |= QStyle::State_MouseOver;
+        if (index == current && hasFocus()) 
+            option.state |= QStyle::State_HasFocus;
+
+        if (QAbstractItemDelegate *delegate = itemDelegateForIndex(index)) 
+            delegate->paint(&painter, option, index);
+    }
+}
+
+// Selection & Navigation
+void VariableRowView::setSelection(const QRect &rect, QItemSelectionModel::SelectionFlags command) {
+    if (!isVariable) {
+        QListView::setSelection(rect, command);
+        return;
+    }
+
+    if (!selectionModel()) 
+        return;
+
+    const QRect normalized = rect.normalized();
+    const int top = normalized.top() + verticalOffset();
+    if (top >= contentHeight() || heights.size() == 0) {
+        selectionModel()->select(QItemSelection(), command);
+        return;
+    }
+
+    const int first = rowAtOffset(top);
+    const int last = rowAtOffset(normalized.bottom() + verticalOffset());
+    selectionModel()->select(QItemSelection(rowIndex(first), rowIndex(last)), command);
+}
+
+QRegion VariableRowView::visualRegionForSelection(const QItemSelection &selection) const {
+    if (!isVariable) 
+        return QListView::visualRegionForSelection(selection);
+
+    QRegion region;
+    for (const QItemSelectionRange &range : selection) {
+        const QRect top = visualRect(rowIndex(range.top()));
+        const QRect bottom = visualRect(rowIndex(range.bottom()));
+        region += QRect(top.topLeft(), bottom.bottomRight()).intersected(viewport()->rect());
+    }
+
+    return region;
+}
+
+bool VariableRowView::isNavigable(int row) const {
+    const Qt::ItemFlags flags = model()->flags(rowIndex(row));
+    return (flags & Qt::ItemIsEnabled) && (flags & Qt::ItemIsSelectable);
+}
+
+QModelIndex VariableRowView::moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) {
+    if (!isVariable) 
+        return QListView::moveCursor(cursorAction, modifiers);
+
+    const int count = heights.size();
+    const int row = currentIndex().row();
+
+    // Headers and separators are stepped over
+    const auto step = [this, count](int from, int direction) {
+        for (int r = from; r >= 0 && r < count; r += direction) {
+            if (isNavigable(r)) 
+                return r;
+        }
+        return -1;
+    };
+
+    int target = -1;
+    switch (cursorAction) {
+        case MoveUp:
+        case MovePrevious: target = step(row < 0 ? count - 1 : row - 1, -1); break;
+        case MoveDown:
+        case MoveNext:     target = step(row + 1, 1); break;
+        case MoveHome:     target = step(0, 1); break;
+        case MoveEnd:      target = step(count - 1, -1); break;
+        case MovePageUp:   target = step(rowAtOffset(rowTop(std::max(row, 0)) - viewport()->height()), 1); break;
+        case MovePageDown: target = step(rowAtOffset(rowTop(std::max(row, 0)) + viewport()->height()), -1); break;
+        default: break;
+    }
+
+    return target >= 0 ? rowIndex(target) : currentIndex();
+}
+
+// Model Changes
+void VariableRowView::setModel(QAbstractItemModel *model) {
+    for (const QMetaObject::Connection &connection : std::as_const(modelConnections)) 
+        disconnect(connection);
+    modelConnections.clear();
+
+    QListView::setModel(model);
+
+    // Reorders change which height belongs to which row
+    if (model) {
+        modelConnections << connect(model, &QAbstractItemModel::layoutChanged, this, [this]() {
+            if (isVariable) {
+                rebuildHeights();
+                updateGeometries();
+            }
+        });
+        // Moved rows keep their measured heights
+        modelConnections << connect(model, &QAbstractItemModel::rowsMoved, this, [this](const QModelIndex &parent, int start, int end, const QModelIndex &destination, int row) {
+            if (!isVariable || parent != rootIndex() || destination != rootIndex()) 
+                return;
+
+            heights.move(start, end - start + 1, row);
+            updateGeometries();
+            viewport()->update();
+        });
+    }
+
+    if (isVariable) {
+        rebuildHeights();
+        updateGeometries();
+    }
+}
+
+void VariableRowView::reset() {
+    QListView::reset();
+
+    if (isVariable) {
+        rebuildHeights();
+        updateGeometries();
+    }
+}
+
+void VariableRowView::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles) {
+    QListView::dataChanged(topLeft, bottomRight, roles);
+
+    // Only size hint, row kind and subtitle can change a height
+    const bool affectsHeight = roles.isEmpty() || roles.contains(Qt::SizeHintRole) 
+                            || roles.contains(Qt::UserRole + 7) || roles.contains(Qt::UserRole + 8);
+    if (!isVariable || !affectsHeight || topLeft.parent() != rootIndex()) 
+        return;
+
+    const int first = topLeft.row();
+    const std::vector<int> measured = measureRows(first, std::min(bottomRight.row(), heights.size() - 1));
+    for (size_t i = 0; i < measured.size(); ++i) 
+        heights.set(first + int(i), measured[i]);
+
+    updateGeometries();
+    viewport()->update();
+}
+
+void VariableRowView::rowsInserted(const QModelIndex &parent, int start, int end) {
+    QListView::rowsInserted(parent, start, end);
+
+    if (!isVariable || parent != rootIndex()) 
+        return;
+
+    heights.insert(start, measureRows(start, end));
+    updateGeometries();
+}
+
+void VariableRowView::rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end) {
+    QListView::rowsAboutToBeRemoved(parent, start, end);
+
+    if (!isVariable || parent != rootIndex()) 
+        return;
+
+    heights.remove(start, end - start + 1);
+    updateGeometries();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QListView>
+#include <QAbstractItemModel>
+#include <QAbstractItemDelegate>
+#include <QItemSelectionModel>
+#include <QStyleOptionViewItem>
+#include <QScrollBar>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QCursor>
+#include <QRegion>
+#include <vector>
+#include <algorithm>
+
+#include "FenwickTree.h"
+
+/**
+ * @brief QListView with an optional variable-height mode. Row heights come from the delegate's
+ * sizeHint() (headers, separators, two-line items) and are kept in a FenwickTree, so mapping between
+ * rows and offsets stays O(log n) and only the rows in the viewport are painted.
+ * With the mode off (default) the view behaves exactly like QListView.
+ */
+class VariableRowView : public QListView {
+    Q_OBJECT
+
+    public:
+    explicit VariableRowView(QWidget *parent = nullptr);
+
+    void setVariableRowHeights(bool enable);
+    bool hasVariableRowHeights() const;
+
+    /**
+     * @brief Top of row in content coordinates, rowTop(rowCount) is the content height.
+     */
+    int rowTop(int row) const;
+    int rowHeight(int row) const;
+
+    /**
+     * @brief Row at a content offset, clamped to the last row. -1 for an empty list.
+     */
+    int rowAtOffset(int y) const;
+    int contentHeight() const;
+
+    void setModel(QAbstractItemModel *model) override;
+    QRect visualRect(const QModelIndex &index) const override;
+    QModelIndex indexAt(const QPoint &point) const override;
+    void scrollTo(const QModelIndex &index, ScrollHint hint = EnsureVisible) override;
+    void reset() override;
+
+    protected:
+    void paintEvent(QPaintEvent *event) override;
+    void updateGeometries() override;
+    int verticalOffset() const override;
+    void scrollContentsBy(int dx, int dy) override;
+    void setSelection(const QRect &rect, QItemSelectionModel::SelectionFlags command) override;
+    QRegion visualRegionForSelection(const QItemSelection &selection) const override;
+    QModelIndex moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) override;
+    QSize viewportSizeHint() const override;
+
+    void dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles = QList<int>()) override;
+    void rowsInserted(const QModelIndex &parent, int start, int end) override;
+    void rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end) override;
+
+    private:
+    void rebuildHeights();
+    std::vector<int> measureRows(int first, int last) const;
+    QModelIndex rowIndex(int row) const;
+    bool isNavigable(int row) const;
+
+    bool isVariable = false;
+    FenwickTree heights;
+    QList<QMetaObject::Connection> modelConnections;
+};
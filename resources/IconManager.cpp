@@ -27,22 +27,48 @@ QString IconManager::icon(Icons icon) {
 }
 
 QPixmap IconManager::renderSvg(const QString &iconPath, const QSize &size) {
+    if (iconPath.isEmpty()) 
+        return QPixmap();
+
+    const QString key = cacheKey(iconPath, size);
+
+    QPixmap cached;
+    if (QPixmapCache::find(key, &cached)) 
+        return cached;
+
+    QImage image = rasterize(iconPath, size);
+    if (image.isNull()) 
+        return QPixmap();
+
+    QPixmap pm = QPixmap::fromImage(image);
+    QPixmapCache::insert(key, pm);
+    return pm;
+}
+
+QImage IconManager::rasterize(const QString &iconPath, const QSize &size) {
+    if (iconPath.isEmpty()) 
+        return QImage();
+
     QSvgRenderer svg(iconPath);
     svg.setAspectRatioMode(Qt::KeepAspectRatio);
     
     if (!svg.isValid()) {
         qWarning() << "SVG not valid or not found:" << iconPath;
-        return QPixmap();
+        return QImage();
     }
 
-    // --- Render SVG into 16x16 pixmap ---
-    QPixmap pm(size);
-    pm.fill(Qt::transparent);
+    // --- Render SVG into an image of the requested size ---
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
 
-    QPainter p(&pm);
+    QPainter p(&image);
     p.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
-    svg.render(&p, QRectF(0, 0, pm.width(), pm.height()));
+    svg.render(&p, QRectF(0, 0, image.width(), image.height()));
     p.end();
 
-    return pm;
+    return image;
+}
+
+QString IconManager::cacheKey(const QString &iconPath, const QSize &size) {
+    return QString("svg:%1@%2x%3").arg(iconPath).arg(size.width()).arg(size.height());
 }
\ No newline at end of file
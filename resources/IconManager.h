@@ -2,9 +2,11 @@
 #include <QString>
 #include <QPainter>
 #include <QPixmap>
+#include <QImage>
 #include <QSvgRenderer>
 #include <QSize>
 #include <QDebug>
+#include <QPixmapCache>
 
 #include "Icons.h"
 
@@ -12,5 +14,14 @@ class IconManager {
     
     public:
     static QString icon(Icons icon);
+    /**
+     * @brief Rasterized icons are cached, so repeated paints (and prewarming) only render once.
+     */
     static QPixmap renderSvg(const QString &iconPath, const QSize &size);
+
+    /**
+     * @brief Uncached rasterization into a QImage. Safe to call from worker threads.
+     */
+    static QImage rasterize(const QString &iconPath, const QSize &size);
+    static QString cacheKey(const QString &iconPath, const QSize &size);
 };
\ No newline at end of file